@@ -0,0 +1,254 @@
+#ifndef DENSE_GRAPH_H
+#define DENSE_GRAPH_H
+
+// Dense adjacency-matrix storage for the Dijkstra kernels.
+//
+// The matrix is templated on the weight type so that the 0-9 weights the
+// benchmarks generate can be stored in one byte instead of four: the
+// O(V^2) relaxation scans one row per iteration, so narrower weights cut
+// its memory traffic proportionally. All indexing is 64-bit, so graphs past
+// 46341 vertices (where u * size overflows an int) work, and the visited set
+// is one bit per vertex.
+//
+//   DenseGraph<uint8_t> graph;
+//   if (!graph.allocate(size)) { ... }
+//   graph.generateRandom(seed);
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Distance type and "unreachable" marker for each weight type. One-byte
+// weights keep 32-bit distances (255 * V fits for any V that fits in
+// memory); wider weights use 64-bit or double distances.
+template <class W> struct DenseWeightTraits;
+
+template <> struct DenseWeightTraits<uint8_t> {
+    typedef int32_t Distance;
+    static const char* name() { return "u8"; }
+};
+template <> struct DenseWeightTraits<uint16_t> {
+    typedef int64_t Distance;
+    static const char* name() { return "u16"; }
+};
+template <> struct DenseWeightTraits<int32_t> {
+    typedef int64_t Distance;
+    static const char* name() { return "i32"; }
+};
+template <> struct DenseWeightTraits<float> {
+    typedef double Distance;
+    static const char* name() { return "f32"; }
+};
+
+// Function to get the distance that marks an unreachable vertex
+template <class D>
+inline D unreachableDistance() {
+    return std::numeric_limits<D>::has_infinity ? std::numeric_limits<D>::infinity()
+                                                : std::numeric_limits<D>::max();
+}
+
+// Function to check that a weight read from a file is stored exactly by W:
+// non-negative, in range and, for integer types, integral
+template <class W>
+inline bool denseWeightFits(double w) {
+    if (!(w >= 0.0) || w > (double)std::numeric_limits<W>::max()) return false;
+    return !std::numeric_limits<W>::is_integer || w == std::floor(w);
+}
+
+// Row-major V x V weight matrix; a weight of 0 means no edge
+template <class W>
+class DenseGraph {
+public:
+    typedef W Weight;
+    typedef typename DenseWeightTraits<W>::Distance Distance;
+
+    DenseGraph() : size_(0), weights_(NULL) {}
+    ~DenseGraph() { free(weights_); }
+
+    DenseGraph(const DenseGraph&) = delete;
+    DenseGraph& operator=(const DenseGraph&) = delete;
+
+    // Moving hands the matrix over; the source is left empty
+    DenseGraph(DenseGraph&& other) : size_(other.size_), weights_(other.weights_) {
+        other.size_ = 0;
+        other.weights_ = NULL;
+    }
+    DenseGraph& operator=(DenseGraph&& other) {
+        if (this != &other) {
+            free(weights_);
+            size_ = other.size_;
+            weights_ = other.weights_;
+            other.size_ = 0;
+            other.weights_ = NULL;
+        }
+        return *this;
+    }
+
+    // Function to allocate a zeroed size x size matrix. Returns false if the
+    // allocation fails.
+    bool allocate(long size) {
+        free(weights_);
+        size_ = size;
+        weights_ = (W*)calloc((size_t)size * (size_t)size, sizeof(W));
+        return weights_ != NULL;
+    }
+
+    long size() const { return size_; }
+    size_t bytes() const { return (size_t)size_ * (size_t)size_ * sizeof(W); }
+
+    W* row(long u) { return weights_ + (size_t)u * (size_t)size_; }
+    const W* row(long u) const { return weights_ + (size_t)u * (size_t)size_; }
+    W weight(long u, long v) const { return row(u)[v]; }
+    void setWeight(long u, long v, W w) { row(u)[v] = w; }
+
+    // Function to fill the matrix with a random undirected graph with
+    // weights in [0, 9], the distribution all the Dijkstra binaries use
+    void generateRandom(unsigned int seed) {
+        srand(seed);
+        for (long i = 0; i < size_; i++) {
+            row(i)[i] = 0;
+            for (long j = i + 1; j < size_; j++) {
+                W w = (W)(rand() % 10);
+                row(i)[j] = w;
+                row(j)[i] = w;
+            }
+        }
+    }
+
+    // Function to read a graph in the matrix input format: a "n n" header
+    // followed by n x n weights. Weights W cannot hold exactly (e.g. 300 or
+    // 2.5 for u8) are rejected rather than wrapped or truncated. Returns
+    // false and fills in error on failure.
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream input(path);
+        if (!input.is_open()) {
+            error = "Unable to open graph file " + path;
+            return false;
+        }
+
+        long rows = 0, cols = 0;
+        input >> rows >> cols;
+        if (!input || rows <= 0 || rows != cols) {
+            error = "Graph file " + path + " must start with a square size";
+            return false;
+        }
+        if (!allocate(rows)) {
+            error = "Unable to allocate the graph of " + path;
+            return false;
+        }
+
+        double w;
+        for (size_t i = 0; i < (size_t)rows * (size_t)cols && input >> w; i++) {
+            if (!denseWeightFits<W>(w)) {
+                std::ostringstream message;
+                message << "Graph file " << path << " has weight " << w << " at row " << i / cols << ", column "
+                        << i % cols << ", which " << DenseWeightTraits<W>::name() << " weights cannot hold";
+                error = message.str();
+                return false;
+            }
+            weights_[i] = (W)w;
+        }
+        if (!input) {
+            error = "Graph file " + path + " is truncated";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    long size_;
+    W* weights_;
+};
+
+// One bit per vertex
+class VisitedSet {
+public:
+    explicit VisitedSet(long size = 0) : words_((size + 63) / 64, 0) {}
+
+    void reset(long size) { words_.assign((size + 63) / 64, 0); }
+    bool test(long v) const { return (words_[v >> 6] >> (v & 63)) & 1; }
+    void set(long v) { words_[v >> 6] |= (uint64_t)1 << (v & 63); }
+
+    const uint64_t* words() const { return words_.data(); }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+// Weight types selectable with --weights=
+enum class DenseWeightType { U8, U16, I32, F32 };
+
+// Function to parse a --weights= value
+inline bool parseDenseWeightType(const std::string& text, DenseWeightType& type) {
+    if (text == "u8") type = DenseWeightType::U8;
+    else if (text == "u16") type = DenseWeightType::U16;
+    else if (text == "i32") type = DenseWeightType::I32;
+    else if (text == "f32") type = DenseWeightType::F32;
+    else return false;
+    return true;
+}
+
+// Function to sum the reachable distances, printed by the binaries so that
+// the result of a run is observable (and cannot be optimized away)
+template <class D>
+double distanceChecksum(const std::vector<D>& dist) {
+    double sum = 0.0;
+    for (D d : dist) {
+        if (d != unreachableDistance<D>()) sum += (double)d;
+    }
+    return sum;
+}
+
+// Function to check that dist holds the shortest distances from src without
+// recomputing them. With positive weights the distances are exact iff
+// dist[src] is 0, no edge can still be relaxed (dist[v] <= dist[u] + w for
+// every edge from a reached u) and every other reached vertex has a tight
+// incoming edge (dist[v] == dist[u] + w for some u). One parallel scan of
+// the matrix, i.e. one relaxation pass of the algorithm. Returns the first
+// vertex that violates a condition, or -1 if dist is correct. The pragmas
+// are guarded by _OPENMP, so kernels built without -fopenmp scan serially.
+template <class W, class D>
+long verifyShortestPaths(const DenseGraph<W>& graph, long src, const std::vector<D>& dist, int threads) {
+    const long size = graph.size();
+    const D unreachable = unreachableDistance<D>();
+    if (dist[src] != 0) return src;
+
+    std::vector<char> tight(size, 0);
+    tight[src] = 1;
+    long first_bad = -1;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+#endif
+    for (long u = 0; u < size; u++) {
+        if (dist[u] == unreachable) continue;
+        const W* row = graph.row(u);
+        for (long v = 0; v < size; v++) {
+            if (!row[v] || v == u) continue;
+            const D through = dist[u] + (D)row[v];
+            if (dist[v] > through) {
+#ifdef _OPENMP
+                #pragma omp critical
+#endif
+                if (first_bad < 0 || v < first_bad) first_bad = v;
+            } else if (dist[v] == through) {
+#ifdef _OPENMP
+                #pragma omp atomic write
+#endif
+                tight[v] = 1;
+            }
+        }
+    }
+
+    for (long v = 0; v < size && (first_bad < 0 || v < first_bad); v++) {
+        if (dist[v] != unreachable && !tight[v]) first_bad = v;
+    }
+    return first_bad;
+}
+
+#endif // DENSE_GRAPH_H
@@ -0,0 +1,136 @@
+#ifndef DENSE_RELAX_H
+#define DENSE_RELAX_H
+
+// Fused relaxation and minimum search for the dense Dijkstra kernels.
+//
+// relaxRowAndFindMin() relaxes dist[lo, hi) through one row of the graph and,
+// in the same pass, finds the unvisited vertex with the smallest (updated)
+// distance. Dijkstra then streams each row once per iteration instead of
+// scanning the row and the distance array separately:
+//
+//   DenseCandidate<D> next;
+//   relaxRowAndFindMin(graph.row(u), dist[u], dist, visited.words(), 0, size, next);
+//   u = next.vertex;
+//
+// Ranges from different threads must not overlap; each thread keeps its own
+// candidate and the candidates are combined with better(). Ties go to the
+// lowest vertex, so the result does not depend on how the range is split.
+//
+// With AVX2 (-mavx2 or -march=native, i.e. the *_native CMake targets) the
+// u8-weight kernel processes 8 vertices per instruction, using the weight as
+// the edge mask and the visited bits as the update mask, with no branches.
+// Other weight types, and builds without AVX2, use the scalar loop.
+
+#include <stdint.h>
+
+#include "dense_graph.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Closest unvisited vertex seen so far; vertex is -1 when none is reachable
+template <class D>
+struct DenseCandidate {
+    D distance;
+    long vertex;
+
+    DenseCandidate() : distance(unreachableDistance<D>()), vertex(-1) {}
+    DenseCandidate(D d, long v) : distance(d), vertex(v) {}
+
+    bool better(const DenseCandidate& other) const {
+        return distance < other.distance || (distance == other.distance && vertex < other.vertex);
+    }
+    void merge(const DenseCandidate& other) {
+        if (other.better(*this)) *this = other;
+    }
+};
+
+// Function to relax and scan dist[lo, hi) one vertex at a time
+template <class W, class D>
+inline void relaxRowAndFindMinScalar(const W* row, D du, D* dist, const uint64_t* visited,
+                                     long lo, long hi, DenseCandidate<D>& best)
+{
+    for (long v = lo; v < hi; v++) {
+        if ((visited[v >> 6] >> (v & 63)) & 1) continue;
+        D d = dist[v];
+        if (row[v] && du + (D)row[v] < d) {
+            d = du + (D)row[v];
+            dist[v] = d;
+        }
+        if (d < best.distance) best = DenseCandidate<D>(d, v);
+    }
+}
+
+// Function to relax dist[lo, hi) through row and fold the closest unvisited
+// vertex into best
+template <class W, class D>
+inline void relaxRowAndFindMin(const W* row, D du, D* dist, const uint64_t* visited,
+                               long lo, long hi, DenseCandidate<D>& best)
+{
+    relaxRowAndFindMinScalar(row, du, dist, visited, lo, hi, best);
+}
+
+#ifdef __AVX2__
+// u8 weights with int32 distances: 8 vertices per step
+template <>
+inline void relaxRowAndFindMin<uint8_t, int32_t>(const uint8_t* row, int32_t du, int32_t* dist,
+                                                 const uint64_t* visited, long lo, long hi,
+                                                 DenseCandidate<int32_t>& best)
+{
+    // Scalar up to the first multiple of 8, so each step covers one byte of
+    // the visited bitmap
+    long head = (lo + 7) & ~7L;
+    if (head > hi) head = hi;
+    relaxRowAndFindMinScalar(row, du, dist, visited, lo, head, best);
+
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i none = _mm256_set1_epi32(INT32_MAX);
+    const __m256i vdu = _mm256_set1_epi32(du);
+    const __m256i step = _mm256_set1_epi32(8);
+
+    // Per-lane minimum and its offset from head; offsets fit in 32 bits
+    // because a dense graph with 2^31 vertices does not fit in memory
+    __m256i vmin = none;
+    __m256i vidx = _mm256_set1_epi32(-1);
+    __m256i offset = lane_offsets;
+
+    long v = head;
+    for (; v + 8 <= hi; v += 8) {
+        __m256i w = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row + v)));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dist + v));
+
+        // Lanes whose visited bit is set
+        int bits = (int)((visited[v >> 6] >> (v & 63)) & 0xff);
+        __m256i seen = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(bits), lane_bits), lane_bits);
+
+        // Update where there is an edge, the lane is unvisited and du + w < d
+        __m256i nd = _mm256_add_epi32(vdu, w);
+        __m256i update = _mm256_andnot_si256(_mm256_or_si256(seen, _mm256_cmpeq_epi32(w, zero)),
+                                             _mm256_cmpgt_epi32(d, nd));
+        d = _mm256_blendv_epi8(d, nd, update);
+        _mm256_storeu_si256((__m256i*)(dist + v), d);
+
+        // Track the smallest unvisited distance per lane; strict < keeps the
+        // lowest vertex for equal distances
+        __m256i candidate = _mm256_blendv_epi8(d, none, seen);
+        __m256i lower = _mm256_cmpgt_epi32(vmin, candidate);
+        vmin = _mm256_blendv_epi8(vmin, candidate, lower);
+        vidx = _mm256_blendv_epi8(vidx, offset, lower);
+        offset = _mm256_add_epi32(offset, step);
+    }
+
+    int32_t mins[8], idxs[8];
+    _mm256_storeu_si256((__m256i*)mins, vmin);
+    _mm256_storeu_si256((__m256i*)idxs, vidx);
+    for (int lane = 0; lane < 8; lane++) {
+        if (idxs[lane] >= 0) best.merge(DenseCandidate<int32_t>(mins[lane], head + idxs[lane]));
+    }
+
+    relaxRowAndFindMinScalar(row, du, dist, visited, v, hi, best);
+}
+#endif
+
+#endif // DENSE_RELAX_H
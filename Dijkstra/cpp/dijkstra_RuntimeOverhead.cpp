@@ -8,121 +8,133 @@
 #include <vector>
 #include <iomanip>
 #include <thread>
+#include <map>
+#include <string>
 
-struct TimingMetrics {
-    double thread_creation_time;
-    double thread_termination_time;
-    double parallel_region_overhead;
-    double critical_section_time;
-    double barrier_sync_time;
-    double reduction_operation_time;
-    double scheduling_overhead;
-    double memory_allocation_time;
-    double data_distribution_time;
-    double load_balancing_time;
-    
-    void print() {
-        std::cout << std::fixed << std::setprecision(3)
-                  << "\nDetailed OpenMP Timing Metrics (microseconds):\n"
-                  << "1. Thread Creation Overhead: " << thread_creation_time << "\n"
-                  << "2. Thread Termination Overhead: " << thread_termination_time << "\n"
-                  << "3. Parallel Region Overhead: " << parallel_region_overhead << "\n"
-                  << "4. Critical Section Time: " << critical_section_time << "\n"
-                  << "5. Barrier Synchronization Time: " << barrier_sync_time << "\n"
-                  << "6. Reduction Operation Time: " << reduction_operation_time << "\n"
-                  << "7. Task Scheduling Overhead: " << scheduling_overhead << "\n"
-                  << "8. Memory Allocation Time: " << memory_allocation_time << "\n"
-                  << "9. Data Distribution Time: " << data_distribution_time << "\n"
-                  << "10. Load Balancing Time: " << load_balancing_time << "\n";
-    }
-};
-
-// Function to measure time difference in microseconds
-double get_time_diff(std::chrono::high_resolution_clock::time_point start, 
-                    std::chrono::high_resolution_clock::time_point end) {
-    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+// This binary exists to report the trace, so tracing is always compiled in
+#ifndef ENABLE_TRACING
+#define ENABLE_TRACING
+#endif
+#include "../../common/trace.h"
+#include "../../common/autotune.h"
+#include "dense_graph.h"
+
+// Runtime overhead breakdown of the parallel Dijkstra kernel.
+//
+// Every phase is recorded with the tracing subsystem in common/trace.h: each
+// thread writes timestamp-counter events into its own buffer, and the
+// per-phase totals are kept alongside the buffers. No clock call, atomic or
+// critical section is added to the measured regions, so the instrumentation
+// does not distort the numbers it reports. The full timeline is written to
+// $TRACE_FILE (default trace.json) for chrome://tracing or ui.perfetto.dev.
+
+// Phases in report order. The unsuffixed Dijkstra phases are recorded by
+// the master around a whole construct, the suffixed ones by every thread.
+static const char* const kPhases[] = {
+    "omp.fork", "omp.join", "omp.barrier", "omp.reduction", "alloc", "init",
+    "dijkstra.min", "dijkstra.min.scan", "dijkstra.min.critical", "dijkstra.relax", "dijkstra.relax.loop"};
+
+// Function to print the per-phase totals as a percentage of the wall time
+void printMetrics(double total_time) {
+    std::map<std::string, TracePhaseSummary> summary = traceSummary();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "\nDetailed OpenMP Timing Metrics (microseconds, mean per participating thread):\n"
+              << std::left << std::setw(24) << "Phase" << std::right << std::setw(10) << "Calls"
+              << std::setw(9) << "Threads" << std::setw(16) << "Time" << std::setw(14) << "Max event"
+              << std::setw(10) << "% total" << "\n";
+    for (const char* name : kPhases) {
+        auto it = summary.find(name);
+        if (it == summary.end()) continue;
+        const TracePhaseSummary& s = it->second;
+        double per_thread = s.total_us / s.threads;
+        std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << s.count
+                  << std::setw(9) << s.threads << std::setw(16) << per_thread << std::setw(14) << s.max_us
+                  << std::setw(10) << (total_time > 0.0 ? 100.0 * per_thread / total_time : 0.0) << "\n";
+    }
+
+    // The totals are kept outside the ring buffers, so they are complete even
+    // when the timeline in the trace file is not
+    uint64_t dropped = traceDropped();
+    if (dropped > 0) {
+        std::cout << "Trace events dropped from the timeline: " << dropped
+                  << " (counted in the totals above; raise TRACE_BUFFER_EVENTS for a full trace)\n";
+    }
 }
 
 // Measure thread creation and termination overhead
-void measure_thread_operations(TimingMetrics& metrics) {
-    auto create_start = std::chrono::high_resolution_clock::now();
-    auto term_start = create_start; // Initialize term_start here
-    
+void measure_thread_operations() {
+    TraceBuffer* master = traceThreadBuffer();
+    uint64_t fork_start = traceTicks();
+    uint64_t join_start = fork_start;
+
     #pragma omp parallel
     {
+        traceThreadBuffer();
         #pragma omp barrier
         #pragma omp single
         {
-            auto create_end = std::chrono::high_resolution_clock::now();
-            metrics.thread_creation_time = get_time_diff(create_start, create_end);
+            master->record("omp.fork", fork_start, traceTicks());
         }
-        
+
         std::this_thread::sleep_for(std::chrono::microseconds(1));
-        
+
         #pragma omp barrier
         #pragma omp single
         {
-            term_start = std::chrono::high_resolution_clock::now();
+            join_start = traceTicks();
         }
     }
-    auto term_end = std::chrono::high_resolution_clock::now();
-    metrics.thread_termination_time = get_time_diff(term_start, term_end);
+    master->record("omp.join", join_start, traceTicks());
 }
 
 // Measure barrier synchronization overhead
-void measure_barrier_sync(TimingMetrics& metrics) {
+void measure_barrier_sync() {
     #pragma omp parallel
     {
-        auto start = std::chrono::high_resolution_clock::now();
+        TRACE_SCOPE("omp.barrier");
         #pragma omp barrier
-        auto end = std::chrono::high_resolution_clock::now();
-        
-        #pragma omp critical
-        {
-            metrics.barrier_sync_time += get_time_diff(start, end);
-        }
     }
 }
 
 // Measure reduction operation overhead
-void measure_reduction(TimingMetrics& metrics, int size) {
+void measure_reduction(int size) {
     std::vector<int> data(size, 1);
     int sum = 0;
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    #pragma omp parallel for reduction(+:sum)
-    for(int i = 0; i < size; i++) {
-        sum += data[i];
+
+    {
+        TRACE_SCOPE("omp.reduction");
+        #pragma omp parallel for reduction(+:sum)
+        for(int i = 0; i < size; i++) {
+            sum += data[i];
+        }
     }
-    auto end = std::chrono::high_resolution_clock::now();
-    metrics.reduction_operation_time = get_time_diff(start, end);
+    if (sum != size) std::cerr << "Reduction check failed." << std::endl;
 }
 
-int minDistance(int* dist, bool* visited, int size, TimingMetrics& metrics)
+int minDistance(int* dist, bool* visited, int size)
 {
     int min = INT_MAX;
     int min_index = -1;
-    
-    auto start_parallel = std::chrono::high_resolution_clock::now();
+
+    TRACE_SCOPE("dijkstra.min");
     #pragma omp parallel
     {
         int local_min = INT_MAX;
         int local_min_index = -1;
 
-        auto scheduling_start = std::chrono::high_resolution_clock::now();
-        #pragma omp for nowait
-        for (int i = 0; i < size; i++) {
-            if (!visited[i] && dist[i] < local_min) {
-                local_min = dist[i];
-                local_min_index = i;
+        {
+            TRACE_SCOPE("dijkstra.min.scan");
+            #pragma omp for nowait
+            for (int i = 0; i < size; i++) {
+                if (!visited[i] && dist[i] < local_min) {
+                    local_min = dist[i];
+                    local_min_index = i;
+                }
             }
         }
-        auto scheduling_end = std::chrono::high_resolution_clock::now();
-        
-        #pragma omp atomic
-        metrics.scheduling_overhead += get_time_diff(scheduling_start, scheduling_end);
 
-        auto critical_start = std::chrono::high_resolution_clock::now();
+        TRACE_SCOPE("dijkstra.min.critical");
         #pragma omp critical
         {
             if (local_min < min) {
@@ -130,93 +142,107 @@ int minDistance(int* dist, bool* visited, int size, TimingMetrics& metrics)
                 min_index = local_min_index;
             }
         }
-        auto critical_end = std::chrono::high_resolution_clock::now();
-        
-        #pragma omp atomic
-        metrics.critical_section_time += get_time_diff(critical_start, critical_end);
-    }
-    auto parallel_end = std::chrono::high_resolution_clock::now();
-    metrics.parallel_region_overhead += get_time_diff(start_parallel, parallel_end);
-    
+    }
+
     return min_index;
 }
 
-void dijkstra(int* graph, int src, int size, TimingMetrics& metrics) {
-    auto alloc_start = std::chrono::high_resolution_clock::now();
-    int* distances = (int*)malloc(size * sizeof(int));
-    bool* visited = (bool*)malloc(size * sizeof(bool));
-    auto alloc_end = std::chrono::high_resolution_clock::now();
-    metrics.memory_allocation_time = get_time_diff(alloc_start, alloc_end);
+void dijkstra(const DenseGraph<int32_t>& graph, int src, int size, long long& checksum) {
+    int* distances;
+    bool* visited;
+    {
+        TRACE_SCOPE("alloc");
+        distances = (int*)malloc(size * sizeof(int));
+        visited = (bool*)malloc(size * sizeof(bool));
+    }
 
     if (distances == NULL || visited == NULL) {
         std::cerr << "Memory allocation failed." << std::endl;
         exit(EXIT_FAILURE);
     }
 
-    auto dist_start = std::chrono::high_resolution_clock::now();
-    #pragma omp parallel for
-    for (int i = 0; i < size; i++) {
-        distances[i] = INT_MAX;
-        visited[i] = false;
+    {
+        TRACE_SCOPE("init");
+        #pragma omp parallel for
+        for (int i = 0; i < size; i++) {
+            distances[i] = INT_MAX;
+            visited[i] = false;
+        }
     }
-    auto dist_end = std::chrono::high_resolution_clock::now();
-    metrics.data_distribution_time = get_time_diff(dist_start, dist_end);
 
     distances[src] = 0;
 
     for (int count = 0; count < size - 1; count++) {
-        int u = minDistance(distances, visited, size, metrics);
-        
+        int u = minDistance(distances, visited, size);
+
         if (u == -1 || distances[u] == INT_MAX)
             break;
 
         visited[u] = true;
+        const int32_t* row = graph.row(u);
 
-        auto balance_start = std::chrono::high_resolution_clock::now();
-        #pragma omp parallel for schedule(dynamic)
-        for (int v = 0; v < size; v++) {
-            if (!visited[v] && graph[u*size + v] && 
-                distances[u] != INT_MAX && 
-                distances[u] + graph[u*size + v] < distances[v]) {
-                distances[v] = distances[u] + graph[u*size + v];
+        TRACE_SCOPE("dijkstra.relax");
+        #pragma omp parallel
+        {
+            TRACE_SCOPE("dijkstra.relax.loop");
+            // dynamic unless the autotuner picked another schedule
+            #pragma omp for schedule(runtime)
+            for (int v = 0; v < size; v++) {
+                if (!visited[v] && row[v] && 
+                    distances[u] != INT_MAX && 
+                    distances[u] + row[v] < distances[v]) {
+                    distances[v] = distances[u] + row[v];
+                }
             }
         }
-        auto balance_end = std::chrono::high_resolution_clock::now();
-        metrics.load_balancing_time += get_time_diff(balance_start, balance_end);
+    }
+
+    // Keep the result live so the kernel cannot be optimized away
+    checksum = 0;
+    for (int i = 0; i < size; i++) {
+        if (distances[i] != INT_MAX) checksum += distances[i];
     }
 
     free(distances);
     free(visited);
 }
 
-void generateAdjMatrix(int* adjMatrix, int size) {
+void generateAdjMatrix(DenseGraph<int32_t>& graph, int size) {
     #pragma omp parallel for collapse(2)
     for(int i = 0; i < size; i++) {
         for(int j = 0; j < size; j++) {
             if(i == j) {
-                adjMatrix[i*size + j] = 0;
+                graph.setWeight(i, j, 0);
             } else {
-                adjMatrix[i*size + j] = rand() % 100 + 1;
+                graph.setWeight(i, j, rand() % 100 + 1);
             }
         }
     }
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2 || argc > 3) {
-        std::cerr << "Usage: " << argv[0] << " <graph_size> [num_threads]" << std::endl;
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    AutotuneMode autotune = AutotuneMode::Cache;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (!parseAutotuneFlag(arg, autotune)) args.push_back(arg);
+    }
+
+    if (args.size() < 1 || args.size() > 2) {
+        std::cerr << "Usage: " << argv[0] << " <graph_size> [num_threads] [--autotune[=off]]" << std::endl;
         return EXIT_FAILURE;
     }
 
-    int size = atoi(argv[1]);
+    int size = atoi(args[0].c_str());
     if (size <= 0) {
         std::cerr << "Error: Graph size must be a positive integer." << std::endl;
         return EXIT_FAILURE;
     }
 
     int num_threads;
-    if (argc == 3) {
-        num_threads = atoi(argv[2]);
+    if (args.size() == 2) {
+        num_threads = atoi(args[1].c_str());
         if (num_threads <= 0) {
             std::cerr << "Error: Number of threads must be a positive integer." << std::endl;
             return EXIT_FAILURE;
@@ -226,8 +252,9 @@ int main(int argc, char* argv[]) {
         num_threads = omp_get_max_threads();
     }
 
-    int* graph = (int*)calloc(size*size, sizeof(int));
-    if (graph == NULL) {
+    // 64-bit indexed storage, so graphs past 46341 vertices work
+    DenseGraph<int32_t> graph;
+    if (!graph.allocate(size)) {
         std::cerr << "Memory allocation for graph failed." << std::endl;
         return EXIT_FAILURE;
     }
@@ -235,21 +262,44 @@ int main(int argc, char* argv[]) {
     srand(time(NULL));
     generateAdjMatrix(graph, size);
 
-    TimingMetrics metrics = {};
-    
-    measure_thread_operations(metrics);
-    measure_barrier_sync(metrics);
-    measure_reduction(metrics, size);
-    
+    // Schedule of the relaxation loop and, unless given, the thread count:
+    // searched with --autotune, otherwise taken from the cache. Tuning runs
+    // are dropped from the trace.
+    Autotuner tuner("dijkstra_overhead", size);
+    if (args.size() < 2) tuner.addParam("threads", autotuneThreadCandidates(), num_threads);
+    tuner.addSchedule(omp_sched_dynamic);
+    if (autotune == AutotuneMode::Tune) {
+        tuner.tune([&]() {
+            long long tuning_checksum = 0;
+            tuner.applySchedule();
+            if (tuner.has("threads")) omp_set_num_threads((int)tuner.get("threads"));
+            dijkstra(graph, 0, size, tuning_checksum);
+        }, std::cerr);
+        traceReset();
+    } else if (autotune == AutotuneMode::Cache && tuner.load()) {
+        std::cerr << "Autotune: using " << tuner.describe() << " from " << tuner.path() << std::endl;
+    }
+    if (tuner.has("threads")) {
+        num_threads = (int)tuner.get("threads");
+        omp_set_num_threads(num_threads);
+    }
+    tuner.applySchedule();
+
+    measure_thread_operations();
+    measure_barrier_sync();
+    measure_reduction(size);
+
+    long long checksum = 0;
     auto start = std::chrono::high_resolution_clock::now();
-    dijkstra(graph, 0, size, metrics);
+    dijkstra(graph, 0, size, checksum);
     auto end = std::chrono::high_resolution_clock::now();
-    
-    double total_time = get_time_diff(start, end);
-    
+
+    double total_time = std::chrono::duration<double, std::micro>(end - start).count();
+
     std::cout << "Total Execution Time: " << total_time << " microseconds\n";
-    metrics.print();
+    printMetrics(total_time);
+    std::cerr << "Distance checksum: " << checksum << std::endl;
+    TRACE_WRITE();
 
-    free(graph);
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dense_graph.h"
+#include "dynamic_sssp.h"
+
+// Incremental shortest paths: repair after a batch of edge updates versus a
+// full recomputation.
+//
+// For every batch size the graph goes through a number of rounds. Each round
+// draws a batch of undirected edge updates (see randomBatch()), repairs the
+// distances with DynamicShortestPath::update(), and recomputes them from
+// scratch on the same graph for comparison. The two results must match
+// exactly. Rounds accumulate, so later batches repair an already repaired
+// tree.
+//
+// Compilation Instructions:
+// g++ -O3 -std=c++11 -o dijkstra_dynamic dijkstra_dynamic.cpp
+
+// Function to parse a comma-separated list of positive integers
+bool parseSizes(const std::string& text, std::vector<long>& sizes)
+{
+    std::stringstream stream(text);
+    std::string item;
+    sizes.clear();
+    while (std::getline(stream, item, ',')) {
+        long value = atol(item.c_str());
+        if (value <= 0) return false;
+        sizes.push_back(value);
+    }
+    return !sizes.empty();
+}
+
+// Failed attempts at a targeted update before falling back to a random one
+#define TARGET_ATTEMPTS 64
+
+// Function to draw one batch of edge updates, cycling through three kinds.
+// Uniformly random edges (deleted, or set to a weight in [1, 9]) almost
+// never lie on a shortest path of the dense generated graph, so they alone
+// would leave the repair nothing to do. The other two kinds are aimed at
+// the current shortest-path tree:
+//   - a tree edge pred[v] - v is deleted or made heavier, which invalidates
+//     the subtree below v
+//   - a shortcut u - v with dist[u] + 1 < dist[v] gets weight 1, which
+//     lowers v and propagates from it
+// A targeted draw that finds no candidate falls back to a random edge, and
+// a batch of one is always a tree edge update.
+template <class W, class D>
+std::vector<DenseEdgeUpdate<W> > randomBatch(const DenseGraph<W>& graph, const std::vector<long>& pred,
+                                             const std::vector<D>& dist, long count, std::mt19937& rng)
+{
+    const long size = graph.size();
+    const D unreachable = unreachableDistance<D>();
+    std::uniform_int_distribution<long> vertex(0, size - 1);
+    std::uniform_int_distribution<int> weight(1, 9);
+    std::uniform_int_distribution<int> kind(0, 2);
+
+    std::vector<DenseEdgeUpdate<W> > batch;
+    int misses = 0;
+    while ((long)batch.size() < count) {
+        DenseEdgeUpdate<W> e;
+        e.u = vertex(rng);
+        e.v = vertex(rng);
+        const long target = misses < TARGET_ATTEMPTS ? (long)batch.size() % 3 : 2;
+
+        if (target == 0) {
+            // Tree edge into e.v: delete it or raise its weight
+            if (pred[e.v] < 0) {
+                misses++;
+                continue;
+            }
+            e.u = pred[e.v];
+            const int old = (int)graph.weight(e.u, e.v);
+            e.weight = (old >= 9 || kind(rng) == 0)
+                ? (W)0 : (W)std::uniform_int_distribution<int>(old + 1, 9)(rng);
+        } else if (target == 1) {
+            // Shortcut that lowers e.v
+            if (e.u == e.v || dist[e.u] == unreachable || !(dist[e.u] + 1 < dist[e.v])) {
+                misses++;
+                continue;
+            }
+            e.weight = (W)1;
+        } else {
+            if (e.u == e.v) continue;
+            e.weight = kind(rng) == 0 ? (W)0 : (W)weight(rng);
+        }
+        misses = 0;
+        batch.push_back(e);
+    }
+    return batch;
+}
+
+// Function to run the rounds for every batch size and print the comparison
+template <class W>
+int runBenchmark(long size, const std::vector<long>& batch_sizes, int rounds, unsigned int seed)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    typedef std::chrono::duration<double, std::micro> Micros;
+
+    DenseGraph<W> graph;
+    if (!graph.allocate(size)) {
+        std::cerr << "Unable to allocate " << graph.bytes() << " bytes for the graph." << std::endl;
+        return EXIT_FAILURE;
+    }
+    graph.generateRandom(seed);
+    std::mt19937 rng(seed + 1);
+
+    DynamicShortestPath<W> dynamic;
+    DynamicShortestPath<W> full;
+
+    auto start = Clock::now();
+    dynamic.compute(graph, 0);
+    double initial = Micros(Clock::now() - start).count();
+
+    std::cout << "Graph: " << size << " vertices, " << DenseWeightTraits<W>::name() << " weights, "
+              << rounds << " rounds per batch size\n"
+              << "Initial computation: " << std::fixed << std::setprecision(1) << initial << " microseconds\n\n"
+              << std::left << std::setw(10) << "Batch" << std::right
+              << std::setw(16) << "Repair (us)" << std::setw(14) << "Rows scanned"
+              << std::setw(16) << "Full (us)" << std::setw(12) << "Speedup" << "\n";
+
+    for (long batch_size : batch_sizes) {
+        double repair_total = 0.0, full_total = 0.0;
+        long touched_total = 0;
+
+        for (int round = 0; round < rounds; round++) {
+            std::vector<DenseEdgeUpdate<W> > batch =
+                randomBatch(graph, dynamic.predecessors(), dynamic.distances(), batch_size, rng);
+
+            start = Clock::now();
+            touched_total += dynamic.update(graph, batch);
+            repair_total += Micros(Clock::now() - start).count();
+
+            start = Clock::now();
+            full.compute(graph, 0);
+            full_total += Micros(Clock::now() - start).count();
+
+            if (dynamic.distances() != full.distances()) {
+                std::cerr << "Repaired distances differ from a full recomputation (batch " << batch_size
+                          << ", round " << round << ")." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        std::cout << std::left << std::setw(10) << batch_size << std::right
+                  << std::setw(16) << repair_total / rounds
+                  << std::setw(14) << touched_total / rounds
+                  << std::setw(16) << full_total / rounds
+                  << std::setw(11) << full_total / repair_total << "x\n";
+    }
+
+    std::cerr << "Distance checksum: " << distanceChecksum(dynamic.distances()) << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    std::vector<long> batch_sizes = {1, 10, 100, 1000};
+    int rounds = 5;
+    DenseWeightType weights = DenseWeightType::I32;
+    unsigned int seed = (unsigned int)time(NULL);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--batches=", 0) == 0) {
+            if (!parseSizes(arg.substr(10), batch_sizes)) {
+                std::cerr << "Batch sizes must be a comma-separated list of positive integers." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--rounds=", 0) == 0) {
+            rounds = atoi(arg.substr(9).c_str());
+        } else if (arg.rfind("--weights=", 0) == 0) {
+            if (!parseDenseWeightType(arg.substr(10), weights)) {
+                std::cerr << "Unknown weight type " << arg.substr(10) << " (use u8, u16, i32 or f32)." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = (unsigned int)std::stoul(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() != 1) {
+        std::cerr << "Usage: " << argv[0] << " <graph_size> [--batches=1,10,100,1000] [--rounds=R]"
+                  << " [--weights=u8|u16|i32|f32] [--seed=N]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    long size = atol(args[0].c_str());
+    if (size < 2) {
+        std::cerr << "Error: Graph size must be at least 2." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (rounds <= 0) {
+        std::cerr << "Error: Number of rounds must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    switch (weights) {
+    case DenseWeightType::U8:  return runBenchmark<uint8_t>(size, batch_sizes, rounds, seed);
+    case DenseWeightType::U16: return runBenchmark<uint16_t>(size, batch_sizes, rounds, seed);
+    case DenseWeightType::I32: return runBenchmark<int32_t>(size, batch_sizes, rounds, seed);
+    case DenseWeightType::F32: return runBenchmark<float>(size, batch_sizes, rounds, seed);
+    }
+    return EXIT_FAILURE;
+}
@@ -1,144 +1,224 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h>
-#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 #include <omp.h>
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <string>
 #include <vector>
 
+#include "dense_graph.h"
+#include "dense_relax.h"
+#include "../../common/autotune.h"
+#include "../../common/perf_counters.h"
+#include "../../common/trace.h"
+
+#ifdef USE_WS_POOL
+#include "../../common/ws_pool.h"
+
+// Pool that runs the loops instead of OpenMP, created in main
+static WorkStealingPool* pool = nullptr;
+#endif
+
 // Compilation Instructions:
 // g++ -O2 -fopenmp -std=c++11 -o dijkstraParallel dijkstraParallel.cpp
 
 // Function to print the shortest distances from the source vertex
-void printSolution(int* result, int size)
+template <class D>
+void printSolution(const std::vector<D>& result)
 {
-    printf("Vertex \t\t Distance from Source\n");
-    for (int i = 0; i < size; i++)
-        printf("%d \t\t\t\t %d\n", i, result[i]);
+    std::cout << "Vertex \t\t Distance from Source\n";
+    for (size_t i = 0; i < result.size(); i++)
+        std::cout << i << " \t\t\t\t " << result[i] << "\n";
 }
 
-// Corrected parallel minDistance function
-int minDistance(int* dist, bool* visited, int size)
-{
-    int min = INT_MAX;
-    int min_index = -1;
+// Counter phase, reported when PERF_COUNTERS=1; traced under the same name.
+// The minimum search runs inside the relaxation pass, so there is no
+// separate phase for it.
+static const int PHASE_RELAX = perfRegisterPhase("dijkstra.relax");
+
+// Vertices per unit of work: one word of the visited bitmap, so ranges stay
+// aligned for the vector kernel
+#define DIJKSTRA_BLOCK 64
 
-    // Parallel region to find the minimum distance vertex
+// Function to relax the neighbours of u in parallel and return the closest
+// unvisited vertex afterwards
+template <class W, class D>
+DenseCandidate<D> relaxAndFindMin(const W* row, D du, D* dist, const VisitedSet& visited, long size)
+{
+    const long blocks = (size + DIJKSTRA_BLOCK - 1) / DIJKSTRA_BLOCK;
+#ifdef USE_WS_POOL
+    return pool->parallelReduce(0, blocks, 0, DenseCandidate<D>(),
+        [&](long lo, long hi, int) {
+            PerfScope perf(PHASE_RELAX);
+            TRACE_SCOPE("dijkstra.relax");
+            DenseCandidate<D> local;
+            relaxRowAndFindMin(row, du, dist, visited.words(), lo * DIJKSTRA_BLOCK,
+                               std::min(size, hi * DIJKSTRA_BLOCK), local);
+            return local;
+        },
+        [](DenseCandidate<D> a, const DenseCandidate<D>& b) { a.merge(b); return a; });
+#else
+    DenseCandidate<D> best;
+
+    // Each thread relaxes a contiguous run of blocks, then the thread-local
+    // candidates are combined
     #pragma omp parallel
     {
-        int local_min = INT_MAX;
-        int local_min_index = -1;
-
-        #pragma omp for nowait
-        for (int i = 0; i < size; i++) {
-            if (!visited[i] && dist[i] < local_min) {
-                local_min = dist[i];
-                local_min_index = i;
-            }
-        }
+        PerfScope perf(PHASE_RELAX);
+        TRACE_SCOPE("dijkstra.relax");
+        const long tid = omp_get_thread_num();
+        const long team = omp_get_num_threads();
+        const long lo = std::min(size, blocks * tid / team * DIJKSTRA_BLOCK);
+        const long hi = std::min(size, blocks * (tid + 1) / team * DIJKSTRA_BLOCK);
+
+        DenseCandidate<D> local;
+        relaxRowAndFindMin(row, du, dist, visited.words(), lo, hi, local);
 
-        // Critical section to update the global minimum
         #pragma omp critical
-        {
-            if (local_min < min) {
-                min = local_min;
-                min_index = local_min_index;
-            }
-        }
+        best.merge(local);
     }
 
-    return min_index;
+    return best;
+#endif
 }
 
-// Parallel Dijkstra's algorithm
-void dijkstra(int* graph, int src, int size){
-    // Allocate memory for distances and visited arrays
-    int* distances = (int*)malloc(size * sizeof(int));
-    bool* visited = (bool*)malloc(size * sizeof(bool));
-
-    if (distances == NULL || visited == NULL) {
-        std::cerr << "Memory allocation failed." << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Initialize distances and visited arrays in parallel
-    #pragma omp parallel for
-    for (int i = 0; i < size; i++) {
-        distances[i] = INT_MAX;
-        visited[i] = false;
-    }
+// Parallel Dijkstra's algorithm; returns the distances from src
+template <class W>
+std::vector<typename DenseGraph<W>::Distance> dijkstra(const DenseGraph<W>& graph, long src)
+{
+    typedef typename DenseGraph<W>::Distance D;
+    const long size = graph.size();
 
+    std::vector<D> distances(size, unreachableDistance<D>());
+    VisitedSet visited(size);
     distances[src] = 0;
 
-    for (int count = 0; count < size - 1; count++) {
-        // Pick the minimum distance vertex from the set of vertices not yet processed
-        int u = minDistance(distances, visited, size);
+    // Each iteration streams the row of u once: the relaxation also finds
+    // the vertex to process next
+    long u = src;
+    for (long count = 0; count < size - 1; count++) {
+        // Mark the picked vertex as processed
+        visited.set(u);
+
+        DenseCandidate<D> next = relaxAndFindMin(graph.row(u), distances[u], distances.data(), visited, size);
 
-        // If the smallest distance is INT_MAX, remaining vertices are inaccessible
-        if (u == -1 || distances[u] == INT_MAX)
+        // If no vertex is left at a finite distance, the rest are inaccessible
+        u = next.vertex;
+        if (u == -1)
             break;
-
-        // Mark the picked vertex as processed
-        visited[u] = true;
-
-        // Update distances of adjacent vertices in parallel
-        #pragma omp parallel for
-        for (int v = 0; v < size; v++) {
-            if (!visited[v] && graph[u*size + v] && 
-                distances[u] != INT_MAX && 
-                distances[u] + graph[u*size + v] < distances[v]) {
-                distances[v] = distances[u] + graph[u*size + v];
-            }
-        }
     }
 
     // Uncomment the following line to print the shortest distances
-    // printSolution(distances, size);
+    // printSolution(distances);
 
-    // Free allocated memory
-    free(distances);
-    free(visited);
+    return distances;
 }
 
-// Function to generate a random adjacency matrix for an undirected graph
-void generateAdjMatrix(int* adjMatrix, int size){
-    int temp;
-
-    // Seed the random number generator
-    srand(time(NULL));
+// Function to generate a graph with the given weight type, time Dijkstra on
+// it and print the elapsed microseconds. With verify the distances are
+// checked afterwards (verifyShortestPaths) and a failure is an error. With
+// tune_threads the team size is searched (--autotune) or taken from the cache.
+template <class W>
+int runBenchmark(long size, unsigned int seed, bool verify, bool tune_threads, AutotuneMode autotune)
+{
+    // Allocate memory for the adjacency matrix
+    DenseGraph<W> graph;
+    if (!graph.allocate(size)) {
+        std::cerr << "Unable to allocate " << graph.bytes() << " bytes for the graph." << std::endl;
+        return EXIT_FAILURE;
+    }
 
-    #pragma omp parallel for private(temp)
-    for(int i = 0; i < size; i++){
-        for(int j = i; j < size; j++){
-            if(i == j) {
-                adjMatrix[i*size+j] = 0;
-                continue;
-            }
-            temp = rand() % 10;
-            adjMatrix[i*size + j] = temp;
-            adjMatrix[j*size + i] = temp;
+    // Generate the adjacency matrix
+    graph.generateRandom(seed);
+
+#ifndef USE_WS_POOL
+    // Each row is split into equal runs of blocks by hand, so there is no
+    // schedule to tune, only the team size. Tuning runs are dropped from the
+    // counters and the trace.
+    if (tune_threads && autotune != AutotuneMode::Off) {
+        Autotuner tuner(std::string("dijkstra_par_") + DenseWeightTraits<W>::name(), size);
+        tuner.addParam("threads", autotuneThreadCandidates(), omp_get_max_threads());
+        if (autotune == AutotuneMode::Tune) {
+            tuner.tune([&]() {
+                omp_set_num_threads((int)tuner.get("threads"));
+                dijkstra(graph, 0);
+            }, std::cerr);
+            perfReset();
+            traceReset();
+        } else if (tuner.load()) {
+            std::cerr << "Autotune: using " << tuner.describe() << " from " << tuner.path() << std::endl;
         }
+        omp_set_num_threads((int)tuner.get("threads"));
     }
+#else
+    // The pool keeps the given number of workers
+    (void)tune_threads;
+    if (autotune == AutotuneMode::Tune) std::cerr << "Autotune: pool builds are not tuned" << std::endl;
+#endif
+
+    // Start timing
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Execute Dijkstra's algorithm
+    std::vector<typename DenseGraph<W>::Distance> distances = dijkstra(graph, 0);
 
-    // Optional: Print the adjacency matrix
-    /*
-    for(int i = 0; i < size; i++){
-        for(int j = 0; j < size; j++){
-            // printf("%d ", adjMatrix[i*size + j]);
+    // End timing
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> duration = end - start;
+
+    std::cout << duration.count() << std::endl;
+    std::cerr << "Distance checksum: " << distanceChecksum(distances)
+              << " (" << DenseWeightTraits<W>::name() << " weights)" << std::endl;
+    perfReport(std::cerr);
+    TRACE_WRITE();
+
+    if (verify) {
+        long bad = verifyShortestPaths(graph, 0, distances, omp_get_max_threads());
+        if (bad >= 0) {
+            std::cerr << "Verification failed: distance of vertex " << bad << " is not the shortest." << std::endl;
+            return EXIT_FAILURE;
         }
-        printf("\n");
+        std::cerr << "Verification passed" << std::endl;
     }
-    */
+
+    return EXIT_SUCCESS;
 }
 
 int main(int argc, char* argv[]){
 
-    if (argc < 2 || argc > 3) {
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    DenseWeightType weights = DenseWeightType::I32;
+    unsigned int seed = (unsigned int)time(NULL);
+    bool verify = false;
+    AutotuneMode autotune = AutotuneMode::Cache;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--verify") {
+            verify = true;
+        } else if (parseAutotuneFlag(arg, autotune)) {
+            continue;
+        } else if (arg.rfind("--weights=", 0) == 0) {
+            if (!parseDenseWeightType(arg.substr(10), weights)) {
+                std::cerr << "Unknown weight type " << arg.substr(10) << " (use u8, u16, i32 or f32)." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = (unsigned int)std::stoul(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 1 || args.size() > 2) {
+        std::cerr << "Usage: " << argv[0] << " <graph_size> [num_threads] [--weights=u8|u16|i32|f32] [--seed=N] [--verify] [--autotune[=off]]" << std::endl;
         return EXIT_FAILURE;
     }
 
-    int size = atoi(argv[1]);
+    long size = atol(args[0].c_str());
 
     if (size <= 0) {
         return EXIT_FAILURE;
@@ -146,8 +226,8 @@ int main(int argc, char* argv[]){
 
     // Determine the number of threads
     int num_threads;
-    if (argc == 3) {
-        num_threads = atoi(argv[2]);
+    if (args.size() == 2) {
+        num_threads = atoi(args[1].c_str());
         if (num_threads <= 0) {
             return EXIT_FAILURE;
         }
@@ -157,35 +237,16 @@ int main(int argc, char* argv[]){
         num_threads = omp_get_max_threads();
     }
 
-    // Allocate memory for the adjacency matrix
-    int* graph = (int*)calloc(size*size, sizeof(int));
-    if (graph == NULL) {
-        return EXIT_FAILURE;
-    }
-
-    // Generate the adjacency matrix
-    generateAdjMatrix(graph, size);
-
-
-
-    // Start timing
-    auto start = std::chrono::high_resolution_clock::now();
+#ifdef USE_WS_POOL
+    WorkStealingPool workers(num_threads);
+    pool = &workers;
+#endif
 
-    // Execute Dijkstra's algorithm
-    dijkstra(graph, 0, size);
-
-    // End timing
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::micro> duration = end - start;
-    double seconds = duration.count() / 1000000.0;
-
-    std::cout <<duration.count()<< std::endl;
-
-    // Uncomment the following line to print the shortest distances
-    // printSolution(distances, size);
-
-    // Free allocated memory for the graph
-    free(graph);
-
-    return EXIT_SUCCESS;
+    switch (weights) {
+    case DenseWeightType::U8:  return runBenchmark<uint8_t>(size, seed, verify, args.size() < 2, autotune);
+    case DenseWeightType::U16: return runBenchmark<uint16_t>(size, seed, verify, args.size() < 2, autotune);
+    case DenseWeightType::I32: return runBenchmark<int32_t>(size, seed, verify, args.size() < 2, autotune);
+    case DenseWeightType::F32: return runBenchmark<float>(size, seed, verify, args.size() < 2, autotune);
+    }
+    return EXIT_FAILURE;
 }
@@ -0,0 +1,300 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dense_graph.h"
+#include "dense_relax.h"
+#include "graph_reorder.h"
+
+// Vertex reordering for the shortest path kernels.
+//
+// The graph is renumbered with each requested ordering (graph_reorder.h) and
+// single-source shortest paths from the original vertex 0 are timed on it
+// with two engines:
+//   dense  the fused row-scan kernel of dijkstra_seq (dense_relax.h)
+//   csr    a binary-heap Dijkstra over a compressed adjacency list built
+//          from the matrix, whose distance accesses follow the numbering
+// Distances are mapped back to the original IDs and must match the
+// identity ordering exactly. The table reports the bandwidth and mean edge
+// span of each ordering and the speedup over the identity ordering.
+//
+// Without --input the graph is generated: every edge {i, j} exists with
+// probability --density (and only if |i - j| <= --band when a band is
+// given), with weights in [1, 9]. The vertex labels are then shuffled, so a
+// banded graph arrives with its locality hidden, like real inputs in an
+// arbitrary order.
+//
+// Compilation Instructions:
+// g++ -O3 -std=c++11 -o dijkstra_reorder dijkstra_reorder.cpp
+
+// Compressed adjacency list: the neighbours of u are
+// target[start[u] .. start[u + 1])
+template <class W>
+struct CsrGraph {
+    std::vector<long> start;
+    std::vector<long> target;
+    std::vector<W> weight;
+};
+
+// Function to build the compressed adjacency list of a dense graph
+template <class W>
+void buildCsr(const DenseGraph<W>& graph, CsrGraph<W>& csr) {
+    const long size = graph.size();
+    csr.start.assign(size + 1, 0);
+    csr.target.clear();
+    csr.weight.clear();
+    for (long u = 0; u < size; u++) {
+        const W* row = graph.row(u);
+        for (long v = 0; v < size; v++) {
+            if (row[v]) {
+                csr.target.push_back(v);
+                csr.weight.push_back(row[v]);
+            }
+        }
+        csr.start[u + 1] = (long)csr.target.size();
+    }
+}
+
+// Function to run the fused dense kernel from src
+template <class W>
+std::vector<typename DenseGraph<W>::Distance> denseShortestPaths(const DenseGraph<W>& graph, long src) {
+    typedef typename DenseGraph<W>::Distance D;
+    const long size = graph.size();
+    std::vector<D> distances(size, unreachableDistance<D>());
+    VisitedSet visited(size);
+    distances[src] = 0;
+
+    for (long u = src, count = 0; u != -1 && count < size - 1; count++) {
+        visited.set(u);
+        DenseCandidate<D> next;
+        relaxRowAndFindMin(graph.row(u), distances[u], distances.data(), visited.words(), 0, size, next);
+        u = next.vertex;
+    }
+    return distances;
+}
+
+// Function to run a binary-heap Dijkstra over the adjacency list from src
+template <class W>
+std::vector<typename DenseGraph<W>::Distance> csrShortestPaths(const CsrGraph<W>& csr, long src) {
+    typedef typename DenseGraph<W>::Distance D;
+    typedef std::pair<D, long> Entry;
+    const long size = (long)csr.start.size() - 1;
+    std::vector<D> distances(size, unreachableDistance<D>());
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+
+    distances[src] = 0;
+    heap.push(Entry(0, src));
+    while (!heap.empty()) {
+        Entry top = heap.top();
+        heap.pop();
+        const long u = top.second;
+        if (top.first != distances[u]) continue;
+        for (long e = csr.start[u]; e < csr.start[u + 1]; e++) {
+            const long v = csr.target[e];
+            const D d = top.first + (D)csr.weight[e];
+            if (d < distances[v]) {
+                distances[v] = d;
+                heap.push(Entry(d, v));
+            }
+        }
+    }
+    return distances;
+}
+
+// Function to generate a (possibly banded) random graph with shuffled labels
+template <class W>
+bool generateGraph(DenseGraph<W>& graph, long size, double density, long band, unsigned int seed) {
+    if (!graph.allocate(size)) return false;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> weight(1, 9);
+
+    std::vector<long> label(size);
+    for (long v = 0; v < size; v++) label[v] = v;
+    std::shuffle(label.begin(), label.end(), rng);
+
+    for (long i = 0; i < size; i++) {
+        const long last = band > 0 ? std::min(size - 1, i + band) : size - 1;
+        for (long j = i + 1; j <= last; j++) {
+            if (coin(rng) < density) {
+                W w = (W)weight(rng);
+                graph.setWeight(label[i], label[j], w);
+                graph.setWeight(label[j], label[i], w);
+            }
+        }
+    }
+    return true;
+}
+
+// Function to time fn over repeat runs and return the fastest, in microseconds
+template <class F>
+double bestOf(int repeat, F fn) {
+    double best = 0.0;
+    for (int r = 0; r < repeat; r++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+        if (r == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+// Function to time both engines under every ordering and print the table
+template <class W>
+int runBenchmark(DenseGraph<W>& graph, const std::vector<VertexOrder>& orders, int repeat) {
+    typedef typename DenseGraph<W>::Distance D;
+    const long size = graph.size();
+    std::vector<D> reference;
+    double dense_base = 0.0, csr_base = 0.0;
+
+    std::cout << "Graph: " << size << " vertices, " << DenseWeightTraits<W>::name() << " weights, best of "
+              << repeat << " runs\n\n"
+              << std::left << std::setw(10) << "Ordering" << std::right
+              << std::setw(11) << "Bandwidth" << std::setw(11) << "Mean span"
+              << std::setw(13) << "Order (us)" << std::setw(13) << "Dense (us)" << std::setw(12) << "CSR (us)"
+              << std::setw(10) << "Dense" << std::setw(10) << "CSR" << "\n";
+
+    // The identity ordering is always measured first as the baseline
+    std::vector<VertexOrder> all(1, VertexOrder::IDENTITY);
+    for (VertexOrder order : orders) {
+        if (order != VertexOrder::IDENTITY) all.push_back(order);
+    }
+
+    for (VertexOrder method : all) {
+        std::vector<long> order;
+        double order_time = bestOf(1, [&]() { order = vertexOrder(graph, method, 0); });
+        OrderLocality locality = orderLocality(graph, order);
+
+        DenseGraph<W> renumbered;
+        if (!permuteGraph(graph, order, renumbered)) {
+            std::cerr << "Unable to allocate the renumbered graph." << std::endl;
+            return EXIT_FAILURE;
+        }
+        CsrGraph<W> csr;
+        buildCsr(renumbered, csr);
+        const long src = inverseOrder(order)[0];
+
+        std::vector<D> dense_dist, csr_dist;
+        double dense_time = bestOf(repeat, [&]() { dense_dist = denseShortestPaths(renumbered, src); });
+        double csr_time = bestOf(repeat, [&]() { csr_dist = csrShortestPaths(csr, src); });
+
+        // Results in the original numbering must not depend on the ordering
+        dense_dist = unpermute(dense_dist, order);
+        csr_dist = unpermute(csr_dist, order);
+        if (method == VertexOrder::IDENTITY) {
+            reference = dense_dist;
+            dense_base = dense_time;
+            csr_base = csr_time;
+        }
+        if (dense_dist != reference || csr_dist != reference) {
+            std::cerr << "Distances under the " << vertexOrderName(method)
+                      << " ordering differ from the original numbering." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << std::left << std::setw(10) << vertexOrderName(method) << std::right
+                  << std::setw(11) << locality.bandwidth
+                  << std::setw(11) << std::fixed << std::setprecision(1) << locality.mean_span
+                  << std::setw(13) << order_time << std::setw(13) << dense_time << std::setw(12) << csr_time
+                  << std::setw(9) << std::setprecision(2) << dense_base / dense_time << "x"
+                  << std::setw(9) << csr_base / csr_time << "x\n";
+    }
+
+    std::cerr << "Distance checksum: " << distanceChecksum(reference) << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// Function to generate or load the graph and run the comparison
+template <class W>
+int runReorder(long size, const std::string& input, double density, long band, unsigned int seed,
+               const std::vector<VertexOrder>& orders, int repeat) {
+    DenseGraph<W> graph;
+    if (!input.empty()) {
+        std::string error;
+        if (!graph.load(input, error)) {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else if (!generateGraph(graph, size, density, band, seed)) {
+        std::cerr << "Unable to allocate " << graph.bytes() << " bytes for the graph." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return runBenchmark(graph, orders, repeat);
+}
+
+int main(int argc, char* argv[]) {
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    std::vector<VertexOrder> orders = {VertexOrder::BFS, VertexOrder::RCM, VertexOrder::DEGREE};
+    std::string input;
+    double density = 0.9;
+    long band = 0;
+    int repeat = 3;
+    DenseWeightType weights = DenseWeightType::I32;
+    unsigned int seed = (unsigned int)time(NULL);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--orders=", 0) == 0) {
+            std::stringstream stream(arg.substr(9));
+            std::string name;
+            orders.clear();
+            while (std::getline(stream, name, ',')) {
+                VertexOrder order;
+                if (!parseVertexOrder(name, order)) {
+                    std::cerr << "Unknown ordering " << name << " (use identity, bfs, rcm or degree)." << std::endl;
+                    return EXIT_FAILURE;
+                }
+                orders.push_back(order);
+            }
+        } else if (arg.rfind("--input=", 0) == 0) {
+            input = arg.substr(8);
+        } else if (arg.rfind("--density=", 0) == 0) {
+            density = atof(arg.substr(10).c_str());
+        } else if (arg.rfind("--band=", 0) == 0) {
+            band = atol(arg.substr(7).c_str());
+        } else if (arg.rfind("--repeat=", 0) == 0) {
+            repeat = atoi(arg.substr(9).c_str());
+        } else if (arg.rfind("--weights=", 0) == 0) {
+            if (!parseDenseWeightType(arg.substr(10), weights)) {
+                std::cerr << "Unknown weight type " << arg.substr(10) << " (use u8, u16, i32 or f32)." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = (unsigned int)std::stoul(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    long size = args.size() == 1 ? atol(args[0].c_str()) : 0;
+    if ((input.empty() && (args.size() != 1 || size <= 0)) || (!input.empty() && !args.empty())) {
+        std::cerr << "Usage: " << argv[0] << " <graph_size> | --input=<graph file>"
+                  << " [--orders=bfs,rcm,degree] [--density=P] [--band=B] [--repeat=N]"
+                  << " [--weights=u8|u16|i32|f32] [--seed=N]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (density <= 0.0 || density > 1.0 || band < 0 || repeat <= 0) {
+        std::cerr << "Error: Density must be in (0, 1], band non-negative and repeat positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    switch (weights) {
+    case DenseWeightType::U8:  return runReorder<uint8_t>(size, input, density, band, seed, orders, repeat);
+    case DenseWeightType::U16: return runReorder<uint16_t>(size, input, density, band, seed, orders, repeat);
+    case DenseWeightType::I32: return runReorder<int32_t>(size, input, density, band, seed, orders, repeat);
+    case DenseWeightType::F32: return runReorder<float>(size, input, density, band, seed, orders, repeat);
+    }
+    return EXIT_FAILURE;
+}
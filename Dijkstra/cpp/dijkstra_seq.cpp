@@ -1,124 +1,124 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h>
-#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 #include <iostream>
 #include <chrono>
+#include <string>
+#include <vector>
+
+#include "dense_graph.h"
+#include "dense_relax.h"
 
 // g++ -o dijkstraSeq dijkstraSeq.cpp
 
 // print results
-void printSolution(int * result, int size)
-{
-    for (int i = 0; i < size; i++)
-        printf("%d \t\t\t\t %d\n", i, result[i]);
-}
-
-
-
-// is parallel
-int minDistance(int * dist, bool * visited, int size)
+template <class D>
+void printSolution(const std::vector<D>& result)
 {
-    // Initialize min value
-    int min = INT_MAX;
-    int min_index;
-
-    for (int i = 0; i < size; i++){
-        // debug
-        if (visited[i] == false && dist[i] <= min){
-            min = dist[i];
-            min_index = i;
-        }
-    }
-
-    return min_index;
+    for (size_t i = 0; i < result.size(); i++)
+        std::cout << i << " \t\t\t\t " << result[i] << "\n";
 }
 
 
 
+template <class W>
+std::vector<typename DenseGraph<W>::Distance> dijkstra(const DenseGraph<W>& graph, long src){
 
-void dijkstra(int* graph, int src, int size){
-
-    int* distances = (int*)calloc(size, sizeof(int));
-    bool *visited = (bool*)calloc(size, sizeof(bool));
+    typedef typename DenseGraph<W>::Distance D;
+    const long size = graph.size();
 
-    for (int i = 0; i < size; i++) {
-        distances[i] = INT_MAX;
-        visited[i] = false;
-    }
+    std::vector<D> distances(size, unreachableDistance<D>());
+    VisitedSet visited(size);
 
     distances[src] = 0;
 
-    for (int count = 0; count < size - 1; count++) {
+    // each pass relaxes through u and finds the next u in the same scan of
+    // the row
+    long u = src;
+    for (long count = 0; count < size - 1; count++) {
+
+        visited.set(u);
 
-        int u = minDistance(distances, visited, size);
-        visited[u] = true;
+        DenseCandidate<D> next;
+        relaxRowAndFindMin(graph.row(u), distances[u], distances.data(), visited.words(), 0, size, next);
 
-        // Update dist value of the adjacent vertices of the
-        // picked vertex.
-        for (int v = 0; v < size; v++)
-            if (!visited[v] && graph[u*size + v]
-                && distances[u] != INT_MAX
-                && distances[u] + graph[u*size + v] < distances[v])
-                distances[v] = distances[u] + graph[u*size + v];
+        u = next.vertex;
+        if (u == -1)
+            break;
     }
 
     // print the constructed distance array
-    // printSolution(distances, size);
+    // printSolution(distances);
 
+    return distances;
 }
 
 
 
-// this part doesn't matter, just an input generator
-void generateAdjMatrix(int* adjMatrix, int size){
-
-    int temp;
-
-    for(int i = 0; i < size; i++){
-        for(int j = i; j < size; j++){
-            if(i == j) {
-                adjMatrix[i*size+j] = 0;
-                continue;
-            }
-            temp = rand() % 10;
-            adjMatrix[i*size + j] = temp;
-            adjMatrix[j*size + i] = temp;
-        }
-    }
-
-    // prints adjacency matrix to see see
-    /*
-    for(int i = 0; i < size; i++){
-        for(int j = 0; j < size; j++){
-            printf("%d ", adjMatrix[i*size + j]);
-        }
-        printf("\n");
-    }
-    */
-}
-
-
-// 
-int main(int argc, char* argv[]){
-
-    int size = atoi(argv[1]);
+// generate the graph, time dijkstra on it
+template <class W>
+int runBenchmark(long size, unsigned int seed){
 
     // generate an adjacency matrix used to represent a weighted graph
-    int* graph = (int*)calloc(size*size, sizeof(int));
-    generateAdjMatrix(graph, size);
+    DenseGraph<W> graph;
+    if (!graph.allocate(size)) {
+        std::cerr << "Unable to allocate " << graph.bytes() << " bytes for the graph." << std::endl;
+        return EXIT_FAILURE;
+    }
+    graph.generateRandom(seed);
 
 
     // start clock here
     auto start = std::chrono::high_resolution_clock::now();
 
     // sequential dijkstra
-    dijkstra(graph, 0, size);
+    std::vector<typename DenseGraph<W>::Distance> distances = dijkstra(graph, 0);
 
     // end clock
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::micro> duration = end - start;
     std::cout << duration.count()<< std::endl;
+    std::cerr << "Distance checksum: " << distanceChecksum(distances)
+              << " (" << DenseWeightTraits<W>::name() << " weights)" << std::endl;
 
     return 0;
+}
+
+
+//
+int main(int argc, char* argv[]){
+
+    // split the --options from the positional arguments
+    std::vector<std::string> args;
+    DenseWeightType weights = DenseWeightType::I32;
+    unsigned int seed = (unsigned int)time(NULL);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--weights=", 0) == 0) {
+            if (!parseDenseWeightType(arg.substr(10), weights)) {
+                std::cerr << "Unknown weight type " << arg.substr(10) << " (use u8, u16, i32 or f32)." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = (unsigned int)std::stoul(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() != 1 || atol(args[0].c_str()) <= 0) {
+        std::cerr << "Usage: " << argv[0] << " <graph_size> [--weights=u8|u16|i32|f32] [--seed=N]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    long size = atol(args[0].c_str());
+
+    switch (weights) {
+    case DenseWeightType::U8:  return runBenchmark<uint8_t>(size, seed);
+    case DenseWeightType::U16: return runBenchmark<uint16_t>(size, seed);
+    case DenseWeightType::I32: return runBenchmark<int32_t>(size, seed);
+    case DenseWeightType::F32: return runBenchmark<float>(size, seed);
+    }
+    return EXIT_FAILURE;
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../common/stdpar_util.h"
+#include "dense_graph.h"
+
+// Compilation Instructions:
+// g++ -O3 -std=c++17 -o dijkstra_stdpar dijkstra_stdpar.cpp -ltbb
+
+// Vertex candidate for the next extraction: (distance, vertex). Comparing
+// pairs picks the lowest vertex among equal distances, so the result does not
+// depend on how the reduction is split.
+template <class D>
+using Candidate = std::pair<D, long>;
+
+// Dijkstra's algorithm on the std::execution parallel algorithms. Like the
+// seq and par kernels, each pass relaxes the row of u and finds the next u
+// in the same scan: the transform relaxes v (written by that element only)
+// and yields its candidate, and the reduction picks the minimum.
+template <class W>
+std::vector<typename DenseGraph<W>::Distance> dijkstra(const DenseGraph<W>& graph, long src)
+{
+    typedef typename DenseGraph<W>::Distance D;
+    const long size = graph.size();
+    const D unreachable = unreachableDistance<D>();
+    std::vector<D> distances(size, unreachable);
+    std::vector<char> visited(size, 0);   // char, not bool: vector<bool> has no data()
+    D* dist = distances.data();
+    char* done = visited.data();
+
+    dist[src] = 0;
+
+    long u = src;
+    for (long count = 0; count < size - 1; count++) {
+        done[u] = 1;
+
+        const W* row = graph.row(u);
+        const D du = dist[u];
+        Candidate<D> next = std::transform_reduce(std::execution::par_unseq,
+            CountingIterator(0), CountingIterator(size), Candidate<D>(unreachable, -1),
+            [](const Candidate<D>& a, const Candidate<D>& b) { return b < a ? b : a; },
+            [=](long v) {
+                if (done[v]) return Candidate<D>(unreachable, -1);
+                D d = dist[v];
+                if (row[v] && du + (D)row[v] < d) {
+                    d = du + (D)row[v];
+                    dist[v] = d;
+                }
+                return d < unreachable ? Candidate<D>(d, v) : Candidate<D>(unreachable, -1);
+            });
+
+        // If no vertex is reachable any more, the remaining ones are inaccessible
+        u = next.second;
+        if (u == -1)
+            break;
+    }
+    return distances;
+}
+
+// Function to generate the graph and time Dijkstra on it
+template <class W>
+int runBenchmark(long size, unsigned int seed)
+{
+    DenseGraph<W> graph;
+    if (!graph.allocate(size)) {
+        std::cerr << "Unable to allocate " << graph.bytes() << " bytes for the graph." << std::endl;
+        return EXIT_FAILURE;
+    }
+    graph.generateRandom(seed);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<typename DenseGraph<W>::Distance> distances = dijkstra(graph, 0);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double, std::micro> duration = end - start;
+    std::cout << duration.count() << std::endl;
+    std::cerr << "Distance checksum: " << distanceChecksum(distances)
+              << " (" << DenseWeightTraits<W>::name() << " weights)" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    DenseWeightType weights = DenseWeightType::I32;
+    unsigned int seed = (unsigned int)time(NULL);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--weights=", 0) == 0) {
+            if (!parseDenseWeightType(arg.substr(10), weights)) {
+                std::cerr << "Unknown weight type " << arg.substr(10) << " (use u8, u16, i32 or f32)." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = (unsigned int)std::stoul(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 1 || args.size() > 2) {
+        std::cerr << "Usage: " << argv[0] << " <graph_size> [num_threads] [--weights=u8|u16|i32|f32] [--seed=N]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    long size = atol(args[0].c_str());
+    if (size <= 0) {
+        std::cerr << "Error: Graph size must be a positive integer." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int num_threads = (args.size() == 2) ? atoi(args[1].c_str()) : 0;
+    if (args.size() == 2 && num_threads <= 0) {
+        std::cerr << "Error: Number of threads must be a positive integer." << std::endl;
+        return EXIT_FAILURE;
+    }
+    ParallelismLimit limit(num_threads);
+
+    switch (weights) {
+    case DenseWeightType::U8:  return runBenchmark<uint8_t>(size, seed);
+    case DenseWeightType::U16: return runBenchmark<uint16_t>(size, seed);
+    case DenseWeightType::I32: return runBenchmark<int32_t>(size, seed);
+    case DenseWeightType::F32: return runBenchmark<float>(size, seed);
+    }
+    return EXIT_FAILURE;
+}
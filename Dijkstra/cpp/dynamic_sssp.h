@@ -0,0 +1,225 @@
+#ifndef DYNAMIC_SSSP_H
+#define DYNAMIC_SSSP_H
+
+// Single-source shortest paths on a dense undirected graph that changes by a
+// few edges between queries.
+//
+// compute() runs Dijkstra from scratch and records the distance and the
+// predecessor of every vertex. update() applies a batch of edge changes to
+// the graph and repairs both arrays, touching only the vertices whose
+// distance can change:
+//
+//   1. Each edge that got heavier or was removed and lies on the shortest
+//      path tree invalidates the subtree below it. Those vertices are reset
+//      and re-estimated from their unaffected neighbours.
+//   2. Each edge that got lighter or was inserted may shorten the path to
+//      one of its endpoints, which is lowered directly.
+//   3. A heap-based Dijkstra pass propagates the changed vertices outwards
+//      and stops where no distance improves.
+//
+// Unaffected vertices keep distances that are still realised by a path in
+// the new graph, so the pass only has to lower values, which is what makes
+// the repair exact. Each touched vertex costs one O(V) row scan, against
+// O(V^2) for a full recomputation.
+//
+//   DynamicShortestPath<uint8_t> sp;
+//   sp.compute(graph, 0);
+//   sp.update(graph, batch);     // batch: vector<DenseEdgeUpdate<uint8_t>>
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "dense_graph.h"
+
+// New weight of the undirected edge {u, v}: 0 deletes it, and setting a
+// missing edge inserts it
+template <class W>
+struct DenseEdgeUpdate {
+    long u;
+    long v;
+    W weight;
+};
+
+template <class W>
+class DynamicShortestPath {
+public:
+    typedef typename DenseGraph<W>::Distance Distance;
+
+    DynamicShortestPath() : source_(-1) {}
+
+    // Function to compute distances and predecessors from source from scratch
+    void compute(const DenseGraph<W>& graph, long source);
+
+    // Function to apply a batch of edge updates to graph (both directions)
+    // and repair the distances. Returns the number of vertices whose row was
+    // scanned, i.e. the work done relative to a full run's graph.size().
+    long update(DenseGraph<W>& graph, const std::vector<DenseEdgeUpdate<W> >& batch);
+
+    long source() const { return source_; }
+    const std::vector<Distance>& distances() const { return dist_; }
+    const std::vector<long>& predecessors() const { return pred_; }   // -1 for the source and unreachable vertices
+
+private:
+    typedef std::pair<Distance, long> HeapEntry;
+    typedef std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > Heap;
+
+    // Function to lower dist[v] to d through u, queueing v if it improved
+    void lower(long v, Distance d, long u, Heap& heap) {
+        if (d < dist_[v]) {
+            dist_[v] = d;
+            pred_[v] = u;
+            heap.push(HeapEntry(d, v));
+        }
+    }
+
+    long invalidateSubtrees(const DenseGraph<W>& graph, const std::vector<long>& roots, Heap& heap);
+
+    long source_;
+    std::vector<Distance> dist_;
+    std::vector<long> pred_;
+    std::vector<char> affected_;      // Scratch: vertex lies in an invalidated subtree
+    std::vector<long> child_start_;   // Scratch: shortest path tree as CSR
+    std::vector<long> children_;
+};
+
+template <class W>
+void DynamicShortestPath<W>::compute(const DenseGraph<W>& graph, long source)
+{
+    const long size = graph.size();
+    const Distance unreachable = unreachableDistance<Distance>();
+    source_ = source;
+    dist_.assign(size, unreachable);
+    pred_.assign(size, -1);
+    dist_[source] = 0;
+
+    VisitedSet visited(size);
+    for (long count = 0; count < size; count++) {
+        long u = -1;
+        Distance best = unreachable;
+        for (long v = 0; v < size; v++) {
+            if (!visited.test(v) && dist_[v] < best) {
+                best = dist_[v];
+                u = v;
+            }
+        }
+        if (u == -1) break;
+        visited.set(u);
+
+        const W* row = graph.row(u);
+        for (long v = 0; v < size; v++) {
+            if (!visited.test(v) && row[v] && best + (Distance)row[v] < dist_[v]) {
+                dist_[v] = best + (Distance)row[v];
+                pred_[v] = u;
+            }
+        }
+    }
+}
+
+// Function to reset every vertex below the given tree roots and seed each one
+// with its best distance through a vertex outside the reset set. Returns the
+// number of reset vertices.
+template <class W>
+long DynamicShortestPath<W>::invalidateSubtrees(const DenseGraph<W>& graph, const std::vector<long>& roots, Heap& heap)
+{
+    const long size = graph.size();
+    const Distance unreachable = unreachableDistance<Distance>();
+
+    // Children of every vertex in the current tree
+    child_start_.assign(size + 1, 0);
+    for (long v = 0; v < size; v++) {
+        if (pred_[v] >= 0) child_start_[pred_[v] + 1]++;
+    }
+    for (long v = 0; v < size; v++) child_start_[v + 1] += child_start_[v];
+    children_.resize(child_start_[size]);
+    std::vector<long> fill(child_start_.begin(), child_start_.end() - 1);
+    for (long v = 0; v < size; v++) {
+        if (pred_[v] >= 0) children_[fill[pred_[v]]++] = v;
+    }
+
+    // Collect the subtrees
+    affected_.assign(size, 0);
+    std::vector<long> reset;
+    for (long root : roots) {
+        if (affected_[root]) continue;
+        affected_[root] = 1;
+        size_t first = reset.size();
+        reset.push_back(root);
+        for (size_t i = first; i < reset.size(); i++) {
+            long x = reset[i];
+            for (long c = child_start_[x]; c < child_start_[x + 1]; c++) {
+                if (!affected_[children_[c]]) {
+                    affected_[children_[c]] = 1;
+                    reset.push_back(children_[c]);
+                }
+            }
+        }
+    }
+
+    for (long x : reset) {
+        dist_[x] = unreachable;
+        pred_[x] = -1;
+    }
+
+    // Best estimate through the rest of the tree; the graph is undirected,
+    // so the row of x holds its incoming edges too
+    for (long x : reset) {
+        const W* row = graph.row(x);
+        for (long y = 0; y < size; y++) {
+            if (row[y] && !affected_[y] && dist_[y] != unreachable) {
+                lower(x, dist_[y] + (Distance)row[y], y, heap);
+            }
+        }
+    }
+    return (long)reset.size();
+}
+
+template <class W>
+long DynamicShortestPath<W>::update(DenseGraph<W>& graph, const std::vector<DenseEdgeUpdate<W> >& batch)
+{
+    const long size = graph.size();
+    const Distance unreachable = unreachableDistance<Distance>();
+    Heap heap;
+
+    // Apply the batch, noting tree edges that got heavier or disappeared
+    std::vector<long> roots;
+    for (const DenseEdgeUpdate<W>& e : batch) {
+        if (e.u == e.v) continue;
+        W old = graph.weight(e.u, e.v);
+        graph.setWeight(e.u, e.v, e.weight);
+        graph.setWeight(e.v, e.u, e.weight);
+        if (old && (!e.weight || e.weight > old)) {
+            if (pred_[e.v] == e.u) roots.push_back(e.v);
+            if (pred_[e.u] == e.v) roots.push_back(e.u);
+        }
+    }
+
+    long touched = 0;
+    if (!roots.empty()) touched += invalidateSubtrees(graph, roots, heap);
+
+    // Edges that got lighter or appeared, with their final weight
+    for (const DenseEdgeUpdate<W>& e : batch) {
+        W w = graph.weight(e.u, e.v);
+        if (e.u == e.v || !w) continue;
+        if (dist_[e.u] != unreachable) lower(e.v, dist_[e.u] + (Distance)w, e.u, heap);
+        if (dist_[e.v] != unreachable) lower(e.u, dist_[e.v] + (Distance)w, e.v, heap);
+    }
+
+    // Propagate; entries whose distance has since been lowered are stale
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        long x = top.second;
+        if (top.first != dist_[x]) continue;
+        touched++;
+
+        const W* row = graph.row(x);
+        for (long y = 0; y < size; y++) {
+            if (row[y]) lower(y, top.first + (Distance)row[y], x, heap);
+        }
+    }
+    return touched;
+}
+
+#endif // DYNAMIC_SSSP_H
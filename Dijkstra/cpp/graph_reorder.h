@@ -0,0 +1,229 @@
+#ifndef GRAPH_REORDER_H
+#define GRAPH_REORDER_H
+
+// Vertex renumbering for the dense graph kernels.
+//
+// An ordering is a permutation order[new] = old. permuteGraph() builds the
+// renumbered graph, and results computed on it are mapped back to the
+// original vertex IDs with unpermute():
+//
+//   std::vector<long> order = vertexOrder(graph, VertexOrder::RCM, 0);
+//   DenseGraph<uint8_t> renumbered;
+//   permuteGraph(graph, order, renumbered);
+//   ... run on renumbered from inverse[0] ...
+//   std::vector<D> dist = unpermute(renumbered_dist, order);
+//
+// The orderings only look at which edges exist (weight != 0):
+//   BFS     breadth-first from the given vertex, then from the lowest
+//           unnumbered vertex of each remaining component
+//   RCM     reverse Cuthill-McKee: BFS from a low-degree peripheral vertex
+//           of each component, visiting neighbours by increasing degree,
+//           then reversed; it keeps edges close to the diagonal
+//   DEGREE  by decreasing degree, so hub vertices share cache lines
+// Computing an ordering scans the matrix a few times, i.e. O(V^2).
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "dense_graph.h"
+
+enum class VertexOrder { IDENTITY, BFS, RCM, DEGREE };
+
+// Function to parse an ordering name
+inline bool parseVertexOrder(const std::string& text, VertexOrder& order) {
+    if (text == "identity") order = VertexOrder::IDENTITY;
+    else if (text == "bfs") order = VertexOrder::BFS;
+    else if (text == "rcm") order = VertexOrder::RCM;
+    else if (text == "degree") order = VertexOrder::DEGREE;
+    else return false;
+    return true;
+}
+
+inline const char* vertexOrderName(VertexOrder order) {
+    switch (order) {
+    case VertexOrder::IDENTITY: return "identity";
+    case VertexOrder::BFS: return "bfs";
+    case VertexOrder::RCM: return "rcm";
+    case VertexOrder::DEGREE: return "degree";
+    }
+    return "";
+}
+
+// Function to count the edges of every vertex
+template <class W>
+std::vector<long> vertexDegrees(const DenseGraph<W>& graph) {
+    const long size = graph.size();
+    std::vector<long> degree(size, 0);
+    for (long u = 0; u < size; u++) {
+        const W* row = graph.row(u);
+        for (long v = 0; v < size; v++) {
+            if (v != u && row[v]) degree[u]++;
+        }
+    }
+    return degree;
+}
+
+// Function to append the vertices reachable from start to order in BFS
+// order. Neighbours are taken by increasing degree when by_degree is set,
+// otherwise by index. Returns the index in order where this search began.
+template <class W>
+size_t bfsFrom(const DenseGraph<W>& graph, long start, const std::vector<long>& degree, bool by_degree,
+               std::vector<char>& numbered, std::vector<long>& order) {
+    const long size = graph.size();
+    const size_t first = order.size();
+    std::vector<long> neighbours;
+
+    numbered[start] = 1;
+    order.push_back(start);
+    for (size_t head = first; head < order.size(); head++) {
+        const long u = order[head];
+        const W* row = graph.row(u);
+        neighbours.clear();
+        for (long v = 0; v < size; v++) {
+            if (row[v] && !numbered[v]) {
+                numbered[v] = 1;
+                neighbours.push_back(v);
+            }
+        }
+        if (by_degree) {
+            std::stable_sort(neighbours.begin(), neighbours.end(),
+                             [&](long a, long b) { return degree[a] < degree[b]; });
+        }
+        order.insert(order.end(), neighbours.begin(), neighbours.end());
+    }
+    return first;
+}
+
+// Function to find a pseudo-peripheral vertex of start's component: repeat
+// a BFS from the lowest-degree vertex of the last level while the search
+// gets deeper (George-Liu)
+template <class W>
+long peripheralVertex(const DenseGraph<W>& graph, long start, const std::vector<long>& degree,
+                      const std::vector<char>& numbered) {
+    const long size = graph.size();
+    long root = start;
+    long depth = -1;
+
+    for (;;) {
+        std::vector<long> level(size, -1);
+        std::vector<long> queue(1, root);
+        level[root] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            const long u = queue[head];
+            const W* row = graph.row(u);
+            for (long v = 0; v < size; v++) {
+                if (row[v] && !numbered[v] && level[v] < 0) {
+                    level[v] = level[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+
+        const long last = level[queue.back()];
+        if (last <= depth) return root;
+        depth = last;
+
+        long next = queue.back();
+        for (long v : queue) {
+            if (level[v] == last && degree[v] < degree[next]) next = v;
+        }
+        root = next;
+    }
+}
+
+// Function to compute an ordering; order[new] = old
+template <class W>
+std::vector<long> vertexOrder(const DenseGraph<W>& graph, VertexOrder method, long start) {
+    const long size = graph.size();
+    std::vector<long> order;
+    order.reserve(size);
+
+    if (method == VertexOrder::IDENTITY) {
+        for (long v = 0; v < size; v++) order.push_back(v);
+        return order;
+    }
+
+    std::vector<long> degree = vertexDegrees(graph);
+    if (method == VertexOrder::DEGREE) {
+        for (long v = 0; v < size; v++) order.push_back(v);
+        std::stable_sort(order.begin(), order.end(), [&](long a, long b) { return degree[a] > degree[b]; });
+        return order;
+    }
+
+    std::vector<char> numbered(size, 0);
+    for (long next = start; (long)order.size() < size; next = 0) {
+        while (numbered[next]) next++;
+        if (method == VertexOrder::BFS) {
+            bfsFrom(graph, next, degree, false, numbered, order);
+        } else {
+            long root = peripheralVertex(graph, next, degree, numbered);
+            size_t first = bfsFrom(graph, root, degree, true, numbered, order);
+            std::reverse(order.begin() + first, order.end());
+        }
+    }
+    return order;
+}
+
+// Function to invert an ordering: position[old] = new
+inline std::vector<long> inverseOrder(const std::vector<long>& order) {
+    std::vector<long> position(order.size());
+    for (size_t i = 0; i < order.size(); i++) position[order[i]] = (long)i;
+    return position;
+}
+
+// Function to build the renumbered graph: out[i][j] = graph[order[i]][order[j]].
+// Returns false if the allocation fails.
+template <class W>
+bool permuteGraph(const DenseGraph<W>& graph, const std::vector<long>& order, DenseGraph<W>& out) {
+    const long size = graph.size();
+    if (!out.allocate(size)) return false;
+    for (long i = 0; i < size; i++) {
+        const W* src = graph.row(order[i]);
+        W* dst = out.row(i);
+        for (long j = 0; j < size; j++) dst[j] = src[order[j]];
+    }
+    return true;
+}
+
+// Function to map per-vertex results on the renumbered graph back to the
+// original IDs
+template <class T>
+std::vector<T> unpermute(const std::vector<T>& values, const std::vector<long>& order) {
+    std::vector<T> original(values.size());
+    for (size_t i = 0; i < values.size(); i++) original[order[i]] = values[i];
+    return original;
+}
+
+// Locality of an ordering: the largest and mean distance |new(u) - new(v)|
+// over all edges
+struct OrderLocality {
+    long bandwidth;
+    double mean_span;
+};
+
+template <class W>
+OrderLocality orderLocality(const DenseGraph<W>& graph, const std::vector<long>& order) {
+    const long size = graph.size();
+    std::vector<long> position = inverseOrder(order);
+    OrderLocality locality = {0, 0.0};
+    double total = 0.0;
+    long edges = 0;
+
+    for (long u = 0; u < size; u++) {
+        const W* row = graph.row(u);
+        for (long v = u + 1; v < size; v++) {
+            if (!row[v]) continue;
+            long span = labs(position[u] - position[v]);
+            locality.bandwidth = std::max(locality.bandwidth, span);
+            total += (double)span;
+            edges++;
+        }
+    }
+    locality.mean_span = edges ? total / edges : 0.0;
+    return locality;
+}
+
+#endif // GRAPH_REORDER_H
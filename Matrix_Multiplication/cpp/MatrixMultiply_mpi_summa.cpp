@@ -0,0 +1,332 @@
+#include <mpi.h>
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../../common/blocked_gemm.h"
+
+using namespace std;
+
+// Hybrid MPI + OpenMP matrix multiplication with SUMMA.
+//
+// The ranks form a pr x pc grid and rank (r, c) owns block (r, c) of C, A
+// and B, with rows and columns split as evenly as possible. Each rank reads
+// only its own blocks of the input files. The shared dimension is cut into
+// panels, each owned by one grid column of A and one grid row of B. For
+// every panel the owning column broadcasts its slice of A along the grid
+// rows, the owning row broadcasts its slice of B along the grid columns,
+// and every rank adds the product of the two slices to its block of C with
+// the OpenMP blocked GEMM. The broadcasts are non-blocking and double
+// buffered: the next panel is in flight while the current one is
+// multiplied. C is gathered on rank 0 and written in the input format.
+//
+// Compilation Instructions:
+// mpicxx -O3 -fopenmp -std=c++11 -o MatrixMultiply_mpi_summa MatrixMultiply_mpi_summa.cpp
+// mpirun -np 4 ./MatrixMultiply_mpi_summa matrix1_1000.txt matrix2_1000.txt output.txt 2
+
+// Default width of a panel of the shared dimension
+#define SUMMA_PANEL 256
+
+// Process grid and the communicators along its rows and columns
+struct Grid {
+    int rows, cols;        // pr x pc
+    int row, col;          // This rank's position
+    MPI_Comm row_comm;     // Ranks in the same grid row, ranked by column
+    MPI_Comm col_comm;     // Ranks in the same grid column, ranked by row
+};
+
+// Panel [k0, k1) of the shared dimension and the grid column / row owning it
+struct Panel {
+    long k0, k1;
+    int a_owner;
+    int b_owner;
+};
+
+// Function to get the first index of part p when n items are split into parts
+long block_start(long n, int parts, int p) {
+    return n * p / parts;
+}
+
+// Function to get the part that holds index i
+int block_owner(long n, int parts, long i) {
+    int p = 0;
+    while (block_start(n, parts, p + 1) <= i) p++;
+    return p;
+}
+
+// Function to choose the most square grid with pr * pc = size
+void choose_grid(int size, int &pr, int &pc) {
+    pr = (int)sqrt((double)size);
+    while (size % pr != 0) pr--;
+    pc = size / pr;
+}
+
+// Function to parse a --grid=RxC value
+bool parse_grid(const string &text, int &pr, int &pc) {
+    size_t x = text.find('x');
+    if (x == string::npos) return false;
+    pr = atoi(text.substr(0, x).c_str());
+    pc = atoi(text.substr(x + 1).c_str());
+    return pr > 0 && pc > 0;
+}
+
+// Function to read the "rows cols" header of a matrix file
+bool read_header(const string &filename, long &rows, long &cols) {
+    ifstream input_file(filename);
+    if (!input_file.is_open()) return false;
+    input_file >> rows >> cols;
+    return bool(input_file) && rows > 0 && cols > 0;
+}
+
+// Function to read rows [r0, r1) and columns [c0, c1) of a matrix file into a
+// contiguous row-major block. Matrix files hold one row per line, so the rows
+// before r0 are skipped without parsing them. A file that ends before row r1
+// is rejected.
+bool read_block(const string &filename, long r0, long r1, long c0, long c1, vector<int> &block) {
+    ifstream input_file(filename);
+    if (!input_file.is_open()) return false;
+
+    long rows, cols;
+    input_file >> rows >> cols;
+    input_file.ignore(numeric_limits<streamsize>::max(), '\n');
+    for (long i = 0; i < r0; i++) {
+        input_file.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    const long width = c1 - c0;
+    block.assign((r1 - r0) * width, 0);
+    for (long i = r0; i < r1; i++) {
+        int value;
+        for (long j = 0; j < cols; j++) {
+            input_file >> value;
+            if (j >= c0 && j < c1) block[(i - r0) * width + (j - c0)] = value;
+        }
+        if (input_file.fail()) return false;
+        input_file.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    return true;
+}
+
+// Function to write a row-major matrix in the input format
+void write_matrix(const vector<int> &matrix, long rows, long cols, const string &filename) {
+    ofstream output_file(filename);
+    if (!output_file.is_open()) {
+        cerr << "Error: Unable to open " << filename << " for writing" << endl;
+        return;
+    }
+
+    output_file << rows << " " << cols << endl;
+    for (long i = 0; i < rows; i++) {
+        for (long j = 0; j < cols; j++) {
+            output_file << matrix[i * cols + j] << " ";
+        }
+        output_file << endl;
+    }
+}
+
+// Function to cut the shared dimension into panels of at most width that
+// never straddle a block boundary of A's columns or B's rows
+vector<Panel> make_panels(long k, const Grid &grid, long width) {
+    vector<long> cuts;
+    for (int c = 0; c <= grid.cols; c++) cuts.push_back(block_start(k, grid.cols, c));
+    for (int r = 0; r <= grid.rows; r++) cuts.push_back(block_start(k, grid.rows, r));
+    sort(cuts.begin(), cuts.end());
+    cuts.erase(unique(cuts.begin(), cuts.end()), cuts.end());
+
+    vector<Panel> panels;
+    for (size_t s = 0; s + 1 < cuts.size(); s++) {
+        for (long k0 = cuts[s]; k0 < cuts[s + 1]; k0 += width) {
+            Panel panel;
+            panel.k0 = k0;
+            panel.k1 = min(cuts[s + 1], k0 + width);
+            panel.a_owner = block_owner(k, grid.cols, k0);
+            panel.b_owner = block_owner(k, grid.rows, k0);
+            panels.push_back(panel);
+        }
+    }
+    return panels;
+}
+
+// SUMMA: C_local += sum over panels of A(my rows, panel) * B(panel, my cols)
+void summa(const Grid &grid, long m, long n, long k, const vector<int> &A_local, const vector<int> &B_local,
+           vector<int> &C_local, long width, int thread_count) {
+    const long mloc = block_start(m, grid.rows, grid.row + 1) - block_start(m, grid.rows, grid.row);
+    const long nloc = block_start(n, grid.cols, grid.col + 1) - block_start(n, grid.cols, grid.col);
+    const long ka0 = block_start(k, grid.cols, grid.col), ka_width = block_start(k, grid.cols, grid.col + 1) - ka0;
+    const long kb0 = block_start(k, grid.rows, grid.row);
+
+    vector<Panel> panels = make_panels(k, grid, width);
+    vector<int> a_panel[2], b_panel[2];
+    for (int b = 0; b < 2; b++) {
+        a_panel[b].resize(mloc * width);
+        b_panel[b].resize(width * nloc);
+    }
+    MPI_Request requests[2][2];
+
+    // Function to pack panel t into buffer b and start its broadcasts
+    auto post = [&](size_t t, int b) {
+        const Panel &p = panels[t];
+        const long w = p.k1 - p.k0;
+        if (grid.col == p.a_owner) {
+            for (long i = 0; i < mloc; i++) {
+                copy(A_local.begin() + i * ka_width + (p.k0 - ka0),
+                     A_local.begin() + i * ka_width + (p.k1 - ka0),
+                     a_panel[b].begin() + i * w);
+            }
+        }
+        if (grid.row == p.b_owner) {
+            copy(B_local.begin() + (p.k0 - kb0) * nloc, B_local.begin() + (p.k1 - kb0) * nloc, b_panel[b].begin());
+        }
+        MPI_Ibcast(a_panel[b].data(), (int)(mloc * w), MPI_INT, p.a_owner, grid.row_comm, &requests[b][0]);
+        MPI_Ibcast(b_panel[b].data(), (int)(w * nloc), MPI_INT, p.b_owner, grid.col_comm, &requests[b][1]);
+    };
+
+    if (!panels.empty()) post(0, 0);
+    for (size_t t = 0; t < panels.size(); t++) {
+        const int b = t % 2;
+        // The other buffer was consumed by panel t - 1, so panel t + 1 can
+        // travel while panel t is multiplied
+        if (t + 1 < panels.size()) post(t + 1, 1 - b);
+        MPI_Waitall(2, requests[b], MPI_STATUSES_IGNORE);
+
+        const long w = panels[t].k1 - panels[t].k0;
+        blockedGemm(mloc, nloc, w, a_panel[b].data(), w, b_panel[b].data(), nloc, C_local.data(), nloc, thread_count);
+    }
+}
+
+// Function to collect every rank's block of C on rank 0
+void gather_result(const Grid &grid, int rank, long m, long n, const vector<int> &C_local, vector<int> &C) {
+    if (rank != 0) {
+        MPI_Send(C_local.data(), (int)C_local.size(), MPI_INT, 0, 0, MPI_COMM_WORLD);
+        return;
+    }
+
+    C.assign(m * n, 0);
+    vector<int> block;
+    for (int r = 0; r < grid.rows * grid.cols; r++) {
+        const int gr = r / grid.cols, gc = r % grid.cols;
+        const long r0 = block_start(m, grid.rows, gr), r1 = block_start(m, grid.rows, gr + 1);
+        const long c0 = block_start(n, grid.cols, gc), c1 = block_start(n, grid.cols, gc + 1);
+        if (r == 0) {
+            block = C_local;
+        } else {
+            block.resize((r1 - r0) * (c1 - c0));
+            MPI_Recv(block.data(), (int)block.size(), MPI_INT, r, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        for (long i = r0; i < r1; i++) {
+            copy(block.begin() + (i - r0) * (c1 - c0), block.begin() + (i - r0 + 1) * (c1 - c0), C.begin() + i * n + c0);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Split the --options from the positional arguments
+    vector<string> args;
+    long width = SUMMA_PANEL;
+    int pr = 0, pc = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--panel=", 0) == 0) {
+            width = atol(arg.substr(8).c_str());
+        } else if (arg.rfind("--grid=", 0) == 0) {
+            if (!parse_grid(arg.substr(7), pr, pc)) pr = pc = -1;
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 3 || args.size() > 4 || width <= 0 || pr < 0) {
+        if (rank == 0) {
+            cerr << "Usage: mpirun -np N " << argv[0] << " <matrix1> <matrix2> <output> [threads]"
+                 << " [--panel=W] [--grid=RxC]" << endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    string matrix1_file = args[0];
+    string matrix2_file = args[1];
+    string output_file = args[2];
+    int thread_count = (args.size() == 4) ? stoi(args[3]) : 1; // Default thread count = 1
+
+    if (pr == 0) choose_grid(size, pr, pc);
+    if (pr * pc != size) {
+        if (rank == 0) cerr << "Error: Grid " << pr << "x" << pc << " does not match " << size << " ranks" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    Grid grid;
+    grid.rows = pr;
+    grid.cols = pc;
+    grid.row = rank / pc;
+    grid.col = rank % pc;
+    MPI_Comm_split(MPI_COMM_WORLD, grid.row, grid.col, &grid.row_comm);
+    MPI_Comm_split(MPI_COMM_WORLD, grid.col, grid.row, &grid.col_comm);
+
+    // Every rank checks the shapes and reads only its own blocks
+    long m, k, k2, n;
+    if (!read_header(matrix1_file, m, k) || !read_header(matrix2_file, k2, n) || k != k2) {
+        if (rank == 0) cerr << "Error: Unable to read matrices or their shapes do not match" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    vector<int> A_local, B_local;
+    bool ok = read_block(matrix1_file, block_start(m, pr, grid.row), block_start(m, pr, grid.row + 1),
+                         block_start(k, pc, grid.col), block_start(k, pc, grid.col + 1), A_local)
+           && read_block(matrix2_file, block_start(k, pr, grid.row), block_start(k, pr, grid.row + 1),
+                         block_start(n, pc, grid.col), block_start(n, pc, grid.col + 1), B_local);
+    int all_ok = 0, local_ok = ok ? 1 : 0;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!all_ok) {
+        if (!ok) cerr << "Error: Rank " << rank << " could not read its input blocks" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    const long mloc = block_start(m, pr, grid.row + 1) - block_start(m, pr, grid.row);
+    const long nloc = block_start(n, pc, grid.col + 1) - block_start(n, pc, grid.col);
+    vector<int> C_local(mloc * nloc, 0);
+
+    // Record start time once every rank is ready
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto start = chrono::high_resolution_clock::now();
+
+    summa(grid, m, n, k, A_local, B_local, C_local, width, thread_count);
+
+    // The multiply ends when the slowest rank is done
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto end = chrono::high_resolution_clock::now();
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    vector<int> C;
+    gather_result(grid, rank, m, n, C_local, C);
+
+    if (rank == 0) {
+        write_matrix(C, m, n, output_file);
+
+        // Print output information
+        cout << elapsed.count() << endl;
+        cerr << "Grid: " << pr << " x " << pc << ", panel width " << width
+             << ", " << thread_count << " thread(s) per rank" << endl;
+    }
+
+    MPI_Comm_free(&grid.row_comm);
+    MPI_Comm_free(&grid.col_comm);
+    MPI_Finalize();
+    return 0;
+}
@@ -4,10 +4,51 @@
 #include <omp.h>
 #include <chrono>
 
+#include "../../common/autotune.h"
+#include "../../common/numa_util.h"
+#include "../../common/perf_counters.h"
+#include "../../common/trace.h"
+#include "../../common/verify.h"
+
+#ifdef USE_WS_POOL
+#include "../../common/ws_pool.h"
+
+// Pool that runs the multiply instead of OpenMP, created in main
+static WorkStealingPool* pool = nullptr;
+#endif
+
 using namespace std;
 
+// Counter phase, reported when PERF_COUNTERS=1; traced under the same name
+static const int PHASE_GEMM = perfRegisterPhase("gemm");
+
+// Function to allocate a rows x cols matrix of zeros. In NUMA mode each row is
+// allocated and first touched by the thread that owns it under the static
+// row schedule used by the multiply, so its pages land on that thread's node.
+vector<vector<int>> allocate_matrix(int rows, int cols, bool numa_first_touch, int thread_count) {
+    if (!numa_first_touch) {
+        return vector<vector<int>>(rows, vector<int>(cols, 0));
+    }
+
+    vector<vector<int>> matrix(rows);
+    #pragma omp parallel for num_threads(thread_count) schedule(static)
+    for (int i = 0; i < rows; i++) {
+        matrix[i].assign(cols, 0);
+    }
+    return matrix;
+}
+
+// Function to add the pages of every row of a matrix to a placement report
+void report_placement(const vector<vector<int>> &matrix, const string &name) {
+    NumaPlacement placement;
+    for (const auto &row : matrix) {
+        placement.addRange(row.data(), row.size() * sizeof(int));
+    }
+    placement.print(name);
+}
+
 // Function to read a matrix from a file
-vector<vector<int>> read_matrix(const string &filename) {
+vector<vector<int>> read_matrix(const string &filename, bool numa_first_touch, int thread_count) {
     ifstream input_file(filename);
     if (!input_file.is_open()) {
         exit(1);
@@ -16,7 +57,7 @@ vector<vector<int>> read_matrix(const string &filename) {
     int rows, cols;
     input_file >> rows >> cols;
 
-    vector<vector<int>> matrix(rows, vector<int>(cols));
+    vector<vector<int>> matrix = allocate_matrix(rows, cols, numa_first_touch, thread_count);
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
             input_file >> matrix[i][j];
@@ -49,39 +90,105 @@ void write_matrix(const vector<vector<int>> &matrix, const string &filename) {
 }
 
 // Parallel Matrix Multiplication using OpenMP
-vector<vector<int>> matrix_multiply_parallel(const vector<vector<int>> &A, const vector<vector<int>> &B, int thread_count) {
+vector<vector<int>> matrix_multiply_parallel(const vector<vector<int>> &A, const vector<vector<int>> &B, int thread_count, bool numa_first_touch) {
     int rows = A.size();
     int cols = B[0].size();
     int common_dim = A[0].size();
 
-    vector<vector<int>> C(rows, vector<int>(cols, 0));
+    vector<vector<int>> C = allocate_matrix(rows, cols, numa_first_touch, thread_count);
 
-    // Parallelize the outer loop
-    #pragma omp parallel for num_threads(thread_count) collapse(2)
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            for (int k = 0; k < common_dim; k++) {
-                C[i][j] += A[i][k] * B[k][j];
+#ifdef USE_WS_POOL
+    // Rows are split into ranges that idle workers steal
+    pool->parallelFor(0, rows, 0, [&](long lo, long hi, int) {
+        PerfScope perf(PHASE_GEMM);
+        TRACE_SCOPE("gemm");
+        for (long i = lo; i < hi; i++) {
+            for (int j = 0; j < cols; j++) {
+                for (int k = 0; k < common_dim; k++) {
+                    C[i][j] += A[i][k] * B[k][j];
+                }
+            }
+        }
+    });
+#else
+    // Parallelize the outer loop; the schedule is static unless the
+    // autotuner picked another one (omp_set_schedule)
+    #pragma omp parallel num_threads(thread_count)
+    {
+        PerfScope perf(PHASE_GEMM);
+        TRACE_SCOPE("gemm");
+        #pragma omp for collapse(2) schedule(runtime)
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                for (int k = 0; k < common_dim; k++) {
+                    C[i][j] += A[i][k] * B[k][j];
+                }
             }
         }
     }
+#endif
 
     return C;
 }
 
 int main(int argc, char *argv[]) {
-    if (argc < 4 || argc > 5) {
+    bool numa_first_touch = false;
+    bool numa_report = false;
+    PinMode pin_mode = PinMode::None;
+    int verify_rounds = 0;   // Freivalds rounds, 0 = no verification
+    AutotuneMode autotune = AutotuneMode::Cache;
+
+    // Split the --options from the positional arguments
+    vector<string> args;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--numa") {
+            numa_first_touch = true;
+        } else if (arg == "--numa-report") {
+            numa_report = true;
+        } else if (parseAutotuneFlag(arg, autotune)) {
+            continue;
+        } else if (arg == "--verify") {
+            verify_rounds = 20;
+        } else if (arg.rfind("--verify=", 0) == 0) {
+            verify_rounds = stoi(arg.substr(9));
+            if (verify_rounds <= 0 || verify_rounds > FREIVALDS_MAX_ROUNDS) {
+                cerr << "Error: Verification rounds must be between 1 and " << FREIVALDS_MAX_ROUNDS << endl;
+                return 1;
+            }
+        } else if (arg.rfind("--pin=", 0) == 0) {
+            if (!parsePinMode(arg.substr(6), pin_mode)) {
+                cerr << "Error: Unknown pinning mode " << arg.substr(6) << endl;
+                return 1;
+            }
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 3 || args.size() > 4) {
+        cerr << "Usage: " << argv[0] << " <matrix1> <matrix2> <output> [threads]"
+             << " [--numa] [--pin=compact|scatter] [--numa-report] [--verify[=rounds]]"
+             << " [--autotune[=off]]" << endl;
         return 1;
     }
 
-    string matrix1_file = argv[1];
-    string matrix2_file = argv[2];
-    string output_file = argv[3];
-    int thread_count = (argc == 5) ? stoi(argv[4]) : 1; // Default thread count = 1
+    string matrix1_file = args[0];
+    string matrix2_file = args[1];
+    string output_file = args[2];
+    int thread_count = (args.size() == 4) ? stoi(args[3]) : 1; // Default thread count = 1
+
+    // Pin the team before any matrix is first touched
+    pinThreads(pin_mode, thread_count);
+
+#ifdef USE_WS_POOL
+    WorkStealingPool workers(thread_count);
+    pool = &workers;
+#endif
 
     // Read input matrices
-    vector<vector<int>> A = read_matrix(matrix1_file);
-    vector<vector<int>> B = read_matrix(matrix2_file);
+    vector<vector<int>> A = read_matrix(matrix1_file, numa_first_touch, thread_count);
+    vector<vector<int>> B = read_matrix(matrix2_file, numa_first_touch, thread_count);
 
     // Check if multiplication is valid
     if (A[0].size() != B.size()) {
@@ -91,11 +198,42 @@ int main(int argc, char *argv[]) {
     // Get matrix size (assuming square matrices for output purposes)
     int matrix_order = A.size();
 
+    // The thread count (unless given) and the schedule of the multiply are
+    // searched with --autotune and otherwise taken from the cache. First
+    // touch and pinning are laid out for the static schedule and the given
+    // team, so they keep the defaults; the schedule is set explicitly, since
+    // OMP_SCHEDULE would otherwise pick it for the schedule(runtime) loop.
+    // Tuning runs are dropped from the counters and the trace.
+    Autotuner tuner("matrix_omp_par", matrix_order);
+#ifndef USE_WS_POOL
+    if (!numa_first_touch && pin_mode == PinMode::None) {
+        if (args.size() < 4) tuner.addParam("threads", autotuneThreadCandidates(), thread_count);
+        tuner.addSchedule();
+    } else {
+        omp_set_schedule(omp_sched_static, 0);
+    }
+#else
+    // The pool keeps the given number of workers and splits the work itself
+    if (autotune == AutotuneMode::Tune) cerr << "Autotune: pool builds are not tuned" << endl;
+#endif
+    if (!tuner.empty() && autotune == AutotuneMode::Tune) {
+        tuner.tune([&]() {
+            tuner.applySchedule();
+            matrix_multiply_parallel(A, B, tuner.has("threads") ? (int)tuner.get("threads") : thread_count, false);
+        }, cerr);
+        perfReset();
+        traceReset();
+    } else if (!tuner.empty() && autotune == AutotuneMode::Cache && tuner.load()) {
+        cerr << "Autotune: using " << tuner.describe() << " from " << tuner.path() << endl;
+    }
+    if (tuner.has("threads")) thread_count = (int)tuner.get("threads");
+    tuner.applySchedule();
+
     // Record start time
     auto start = chrono::high_resolution_clock::now();
 
     // Perform matrix multiplication using OpenMP
-    vector<vector<int>> C = matrix_multiply_parallel(A, B, thread_count);
+    vector<vector<int>> C = matrix_multiply_parallel(A, B, thread_count, numa_first_touch);
 
     // Record end time
     auto end = chrono::high_resolution_clock::now();
@@ -103,11 +241,34 @@ int main(int argc, char *argv[]) {
     // Calculate elapsed time in microseconds
     auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
 
+    if (numa_report) {
+        report_placement(A, "A");
+        report_placement(B, "B");
+        report_placement(C, "C");
+    }
+
     // Write result to output file
     write_matrix(C, output_file);
 
     // Print output information
     cout <<elapsed.count()<< endl;
+    perfReport(cerr);
+    TRACE_WRITE();
+
+    // Check C = A * B with Freivalds' test instead of a second multiply
+    if (verify_rounds > 0) {
+        uint64_t seed = (uint64_t)chrono::high_resolution_clock::now().time_since_epoch().count();
+        long bad = freivaldsCheck(A.size(), B.size(), B[0].size(),
+                                  [&](long i) { return A[i].data(); },
+                                  [&](long i) { return B[i].data(); },
+                                  [&](long i) { return C[i].data(); },
+                                  verify_rounds, seed, thread_count);
+        if (bad >= 0) {
+            cerr << "Verification failed: row " << bad << " of the product is wrong" << endl;
+            return 1;
+        }
+        cerr << "Verification passed (" << verify_rounds << " Freivalds rounds)" << endl;
+    }
 
     return 0;
 }
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <execution>
+
+#include "../../common/stdpar_util.h"
+
+using namespace std;
+
+// Compilation Instructions:
+// g++ -O3 -std=c++17 -o MatrixMultiply_stdpar MatrixMultiply_stdpar.cpp -ltbb
+
+// Function to read a matrix from a file
+vector<vector<int>> read_matrix(const string &filename) {
+    ifstream input_file(filename);
+    if (!input_file.is_open()) {
+        exit(1);
+    }
+
+    int rows, cols;
+    input_file >> rows >> cols;
+
+    vector<vector<int>> matrix(rows, vector<int>(cols));
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            input_file >> matrix[i][j];
+        }
+    }
+
+    input_file.close();
+    return matrix;
+}
+
+// Function to write a matrix to a file
+void write_matrix(const vector<vector<int>> &matrix, const string &filename) {
+    ofstream output_file(filename);
+    if (!output_file.is_open()) {
+        cerr << "Error: Unable to open file " << filename << endl;
+        exit(1);
+    }
+
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+    output_file << rows << " " << cols << endl;
+
+    for (const auto &row : matrix) {
+        for (const auto &val : row) {
+            output_file << val << " ";
+        }
+        output_file << endl;
+    }
+
+    output_file.close();
+}
+
+// Matrix multiplication on the std::execution parallel algorithms; rows of C
+// are independent, so the backend distributes them across threads
+vector<vector<int>> matrix_multiply_stdpar(const vector<vector<int>> &A, const vector<vector<int>> &B) {
+    int rows = A.size();
+    int cols = B[0].size();
+    int common_dim = A[0].size();
+
+    vector<vector<int>> C(rows, vector<int>(cols, 0));
+
+    for_each(execution::par, CountingIterator(0), CountingIterator(rows), [&](long i) {
+        for (int j = 0; j < cols; ++j) {
+            for (int k = 0; k < common_dim; ++k) {
+                C[i][j] += A[i][k] * B[k][j];
+            }
+        }
+    });
+
+    return C;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4 || argc > 5) {
+        cerr << "Usage: " << argv[0] << " <matrix1> <matrix2> <output> [threads]" << endl;
+        return 1;
+    }
+
+    string matrix1_file = argv[1];
+    string matrix2_file = argv[2];
+    string output_file = argv[3];
+    int thread_count = (argc == 5) ? stoi(argv[4]) : 0; // Default: all cores
+    ParallelismLimit limit(thread_count);
+
+    // Read matrices from files
+    vector<vector<int>> A = read_matrix(matrix1_file);
+    vector<vector<int>> B = read_matrix(matrix2_file);
+
+    // Check if multiplication is valid
+    if (A[0].size() != B.size()) {
+        return 1;
+    }
+
+    // Record start time
+    auto start = chrono::high_resolution_clock::now();
+
+    // Perform matrix multiplication
+    vector<vector<int>> C = matrix_multiply_stdpar(A, B);
+
+    // Record end time
+    auto end = chrono::high_resolution_clock::now();
+
+    // Calculate elapsed time in microseconds
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    // Write result to output file
+    write_matrix(C, output_file);
+
+    cout <<elapsed.count()<< endl;
+
+    return 0;
+}
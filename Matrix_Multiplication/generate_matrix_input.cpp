@@ -1,89 +1,112 @@
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <random>
 #include <chrono>
 #include <string>
 #include <thread>
-#include <mutex>
 
-// Function to generate a random matrix and save to a file
-void generate_matrix(const std::string& filename, int size, std::mt19937& rng, std::uniform_int_distribution<int>& dist, std::mutex& file_mutex) {
-    // Open file for writing with buffering optimizations
-    std::ofstream file(filename, std::ios::out | std::ios::trunc);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for writing\n";
-        exit(EXIT_FAILURE);
-    }
+#include "../common/fast_io.h"
+#include "../common/philox.h"
 
-    // Write the dimensions of the matrix to the file
-    file << size << " " << size << "\n";
+// Each value is written right-aligned in 3 characters plus a space (values
+// are 1-100), so row i starts at a known offset and chunks of rows can be
+// generated and written by any thread in any order
+#define VALUE_BYTES 4
 
-    // Preallocate a buffer for each row to minimize dynamic memory allocations
-    std::string row;
-    row.reserve(size * 12); // Assuming each number takes up to 11 characters + space
+// Bytes of rows handed to a thread at once
+#define ROW_CHUNK_BYTES (1 << 20)
 
-    for (int i = 0; i < size; ++i) {
-        row.clear();
-        for (int j = 0; j < size; ++j) {
-            row += std::to_string(dist(rng)) + " ";
-        }
-        row += "\n";
-        file << row;
+// Function to generate a random matrix and save it to a file. Entry (i, j)
+// is value i * size + j of Philox stream `stream` keyed by the seed, so the
+// file depends only on the size and the seed, not on the thread count.
+bool generate_matrix(const std::string& filename, int size, uint64_t seed, uint32_t stream, int threads) {
+    PositionedFile file;
+    std::string error;
+    if (!file.open(filename, error)) {
+        std::cerr << "Error: Could not open file " << filename << " for writing\n";
+        return false;
     }
 
-    file.close();
-    std::cout << "Matrix saved to " << filename << "\n";
-}
-
-// Function to generate matrices in parallel
-void generate_matrices_parallel(int size, std::mutex& file_mutex) {
-    // Generate filenames
-    std::string filename1 = "matrix1_" + std::to_string(size) + ".txt";
-    std::string filename2 = "matrix2_" + std::to_string(size) + ".txt";
-
-    // Initialize random number generators
-    std::random_device rd1, rd2;
-    std::mt19937 rng1(rd1());
-    std::mt19937 rng2(rd2());
-    std::uniform_int_distribution<int> dist(1, 100); // Random numbers between 1 and 100
-
-    // Launch threads to generate each matrix concurrently
-    std::thread t1(generate_matrix, filename1, size, std::ref(rng1), std::ref(dist), std::ref(file_mutex));
-    std::thread t2(generate_matrix, filename2, size, std::ref(rng2), std::ref(dist), std::ref(file_mutex));
+    // Write the dimensions of the matrix to the file, then presize it
+    std::string header = std::to_string(size) + " " + std::to_string(size) + "\n";
+    const size_t row_bytes = (size_t)size * VALUE_BYTES + 1;
+    if (!file.resize((off_t)(header.size() + (size_t)size * row_bytes)) ||
+        !file.writeAt(header.data(), header.size(), 0)) {
+        std::cerr << "Error: Could not write file " << filename << "\n";
+        return false;
+    }
 
-    // Wait for both threads to finish
-    t1.join();
-    t2.join();
+    const PhiloxKey key = philoxKeyFromSeed(seed);
+    const long chunk_rows = std::max(1L, (long)(ROW_CHUNK_BYTES / row_bytes));
+    bool written = writeRecords(file, (off_t)header.size(), size, row_bytes, chunk_rows, threads,
+                                [&](long begin, long end, char* out) {
+        PhiloxStream values(key, stream, (uint64_t)begin * (uint64_t)size);
+        for (long i = begin; i < end; ++i) {
+            for (int j = 0; j < size; ++j) {
+                // Random numbers between 1 and 100
+                uint32_t value = 1 + (uint32_t)(((uint64_t)values.next() * 100) >> 32);
+                out[0] = value >= 100 ? '1' : ' ';
+                out[1] = value >= 10 ? (char)('0' + (value / 10) % 10) : ' ';
+                out[2] = (char)('0' + value % 10);
+                out[3] = ' ';
+                out += VALUE_BYTES;
+            }
+            *out++ = '\n';
+        }
+    });
 
-    std::cout << "Both matrices for size " << size << " have been generated.\n";
+    if (!written || !file.close()) {
+        std::cerr << "Error: Could not write file " << filename << "\n";
+        return false;
+    }
+    std::cout << "Matrix saved to " << filename << "\n";
+    return true;
 }
 
 int main(int argc, char* argv[]) {
-    // Check for command-line argument
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <matrix_size>\n";
-        return EXIT_FAILURE;
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    int threads = std::max(1, (int)std::thread::hardware_concurrency());
+    uint64_t seed = std::random_device()();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) {
+            threads = std::atoi(arg.substr(10).c_str());
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::stoull(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
     }
 
-    int size = std::stoi(argv[1]);
-    if (size <= 0) {
-        std::cerr << "Error: Matrix size must be positive.\n";
+    if (args.size() != 1) {
+        std::cerr << "Usage: " << argv[0] << " <matrix_size> [--seed=N] [--threads=T]\n";
         return EXIT_FAILURE;
     }
 
-    // Mutex for thread-safe file operations (if needed in future extensions)
-    std::mutex file_mutex;
+    int size = std::stoi(args[0]);
+    if (size <= 0 || threads <= 0) {
+        std::cerr << "Error: Matrix size and thread count must be positive.\n";
+        return EXIT_FAILURE;
+    }
 
     // Measure the time taken for matrix generation
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Generate both matrices in parallel
-    generate_matrices_parallel(size, file_mutex);
+    // Both matrices use all threads, one after the other, with their own
+    // stream of the seed
+    std::string filename1 = "matrix1_" + std::to_string(size) + ".txt";
+    std::string filename2 = "matrix2_" + std::to_string(size) + ".txt";
+    if (!generate_matrix(filename1, size, seed, 0, threads) ||
+        !generate_matrix(filename2, size, seed, 1, threads)) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Both matrices for size " << size << " have been generated.\n";
 
     auto end_time = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end_time - start_time;
 
+    std::cout << "Seed: " << seed << "\n";
     std::cout << "Total time taken: " << elapsed.count() << " seconds\n";
 
     return EXIT_SUCCESS;
@@ -0,0 +1,167 @@
+#ifndef MONTE_CARLO_ADAPTIVE_H
+#define MONTE_CARLO_ADAPTIVE_H
+
+// Adaptive Monte Carlo: draw blocks of samples until the confidence interval
+// of the mean is narrower than a requested width.
+//
+// Threads claim block indices from a shared counter and fold each finished
+// block into their own statistics slot. A slot has a single writer and is
+// published through a sequence lock, so other threads can read a consistent
+// snapshot without taking a lock. After every block a thread merges all
+// slots and raises the stop flag once the interval is narrow enough; blocks
+// already in flight still finish and are counted.
+//
+// Each block is a deterministic function of its index, but which blocks are
+// evaluated before the stop is seen depends on timing, so adaptive results
+// are not bit-reproducible the way fixed-size runs are.
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <omp.h>
+
+#include "running_stats.h"
+
+struct AdaptiveOptions {
+    double target_width = 0.0;     // Full width of the confidence interval
+    double confidence = 0.95;      // Two-sided confidence level
+    uint64_t max_blocks = 0;       // Sample budget, in blocks
+    uint64_t min_samples = 10000;  // Samples needed before the interval is trusted
+};
+
+struct AdaptiveResult {
+    RunningStats stats;
+    uint64_t blocks = 0;
+    double half_width = 0.0;
+    bool reached_target = false;
+};
+
+// Function to compute the two-sided normal quantile z with
+// P(|Z| <= z) = confidence, by bisection on erf
+inline double normal_quantile(double confidence) {
+    double lo = 0.0, hi = 40.0;
+    for (int i = 0; i < 200; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (std::erf(mid / std::sqrt(2.0)) < confidence) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+// One thread's running statistics. alignas(64) makes the slot exactly one
+// cache line; StatsSlots also places it on a line boundary, so no two
+// threads' slots share a line.
+struct alignas(64) StatsSlot {
+    std::atomic<uint64_t> sequence;   // Odd while the owner is writing
+    std::atomic<uint64_t> n;
+    std::atomic<double> mean;
+    std::atomic<double> m2;
+    uint64_t blocks;                  // Only used by the owner
+
+    StatsSlot() : sequence(0), n(0), mean(0.0), m2(0.0), blocks(0) {}
+
+    // Function to publish new statistics (owner thread only)
+    void publish(const RunningStats& stats) {
+        uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        n.store(stats.n, std::memory_order_relaxed);
+        mean.store(stats.mean, std::memory_order_relaxed);
+        m2.store(stats.m2, std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Function to read a consistent snapshot (any thread)
+    RunningStats snapshot() const {
+        RunningStats stats;
+        while (true) {
+            uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            stats.n = n.load(std::memory_order_relaxed);
+            stats.mean = mean.load(std::memory_order_relaxed);
+            stats.m2 = m2.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) return stats;
+        }
+    }
+};
+
+static_assert(sizeof(StatsSlot) == 64, "StatsSlot must fill exactly one cache line");
+
+// Fixed-size array of cache-line-aligned slots. C++11 new ignores
+// alignas(64), so the storage is over-allocated by one line and the slots
+// start at the first line boundary inside it.
+class StatsSlots {
+public:
+    explicit StatsSlots(int count)
+        : storage_((size_t)count * sizeof(StatsSlot) + alignof(StatsSlot)), count_(count) {
+        void* start = storage_.data();
+        size_t space = storage_.size();
+        slots_ = static_cast<StatsSlot*>(std::align(alignof(StatsSlot), (size_t)count * sizeof(StatsSlot),
+                                                    start, space));
+        for (int i = 0; i < count_; i++) new (&slots_[i]) StatsSlot();
+    }
+    StatsSlots(const StatsSlots&) = delete;
+    StatsSlots& operator=(const StatsSlots&) = delete;
+
+    StatsSlot& operator[](int i) { return slots_[i]; }
+    const StatsSlot* begin() const { return slots_; }
+    const StatsSlot* end() const { return slots_ + count_; }
+
+private:
+    std::vector<char> storage_;
+    int count_;
+    StatsSlot* slots_;
+};
+
+// Function to run sample_block(index) -> RunningStats over block indices
+// 0, 1, 2, ... until the interval target or the block budget is reached.
+// Runs on the current OpenMP team size.
+template <class BlockSampler>
+AdaptiveResult run_adaptive(const BlockSampler& sample_block, const AdaptiveOptions& options) {
+    const double z = normal_quantile(options.confidence);
+    const double target_half_width = 0.5 * options.target_width;
+
+    StatsSlots slots(omp_get_max_threads());
+    std::atomic<uint64_t> next_block(0);
+    std::atomic<bool> stop(false);
+
+    #pragma omp parallel
+    {
+        StatsSlot& slot = slots[omp_get_thread_num()];
+        RunningStats local;
+
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint64_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+            if (block >= options.max_blocks) break;
+
+            local.merge(sample_block(block));
+            slot.blocks++;
+            slot.publish(local);
+
+            // Merge every thread's latest snapshot and check the interval
+            RunningStats total;
+            for (const StatsSlot& other : slots) total.merge(other.snapshot());
+            if (total.n >= options.min_samples && total.n > 1 &&
+                z * std::sqrt(total.variance() / total.n) <= target_half_width) {
+                stop.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    AdaptiveResult result;
+    for (const StatsSlot& slot : slots) {
+        result.stats.merge(slot.snapshot());
+        result.blocks += slot.blocks;
+    }
+    if (result.stats.n > 1) {
+        result.half_width = z * std::sqrt(result.stats.variance() / result.stats.n);
+    }
+    result.reached_target = result.half_width <= target_half_width && result.stats.n >= options.min_samples;
+    return result;
+}
+
+#endif // MONTE_CARLO_ADAPTIVE_H
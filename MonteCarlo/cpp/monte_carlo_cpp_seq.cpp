@@ -1,44 +1,50 @@
 #include <chrono>
 #include <iostream>
+#include <iomanip>
 #include <random>
+#include <string>
 #include <cmath>
-using namespace std;
-using namespace std::chrono;
 
-double estimate_pi(long num_points) {
-    long points_inside = 0;
-    {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> dis(0.0, 1.0);
+#include "monte_carlo_engine.h"
 
-        for (long i = 0; i < num_points; i++) {
-            double x = dis(gen);
-            double y = dis(gen);
+using namespace std;
+using namespace std::chrono;
 
-            if (x*x + y*y <= 1.0) {
-                points_inside++;
-            }
-        }
-    }
+double estimate_pi(long num_points, uint64_t seed) {
+    long points_inside = count_inside_circle(philoxKeyFromSeed(seed), 0, 0, num_points);
 
     return 4.0 * points_inside / num_points;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <num_points>" << std::endl;
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <num_points> [--seed=N]" << std::endl;
         return 1;
     }
 
     const long num_points = std::stol(argv[1]);
 
+    // Same seed handling as the parallel version, which generates sample i
+    // from (seed, i) as well, so both produce the same estimate for a seed
+    uint64_t seed;
+    if (argc == 3 && std::string(argv[2]).rfind("--seed=", 0) == 0) {
+        seed = std::stoull(std::string(argv[2]).substr(7));
+    } else if (argc == 3) {
+        std::cerr << "Usage: " << argv[0] << " <num_points> [--seed=N]" << std::endl;
+        return 1;
+    } else {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
     auto start = std::chrono::high_resolution_clock::now();
-    double pi_estimate = estimate_pi(num_points);
+    double pi_estimate = estimate_pi(num_points, seed);
     auto stop = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
     std::cout << duration.count()<< std::endl;
+    std::cerr << "Seed: " << seed << std::endl;
+    std::cerr << "Estimated pi: " << std::setprecision(17) << pi_estimate << std::endl;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef MONTE_CARLO_ENGINE_H
+#define MONTE_CARLO_ENGINE_H
+
+// Sampling kernel shared by the sequential and OpenMP pi estimators.
+//
+// Samples come from Philox4x32-10: one Philox block (four 32-bit words)
+// gives two points, and blocks are generated MC_BATCH_BLOCKS at a time so the
+// rounds, the integer-to-float conversion and the inside test all run on
+// full SIMD vectors. Sample s of a stream is the point stored in half s % 2
+// of block s / 2, so a range of samples can be generated independently of
+// any other range.
+
+#include <cstdint>
+
+#include "../../common/philox.h"
+
+// Philox blocks generated per batch
+#define MC_BATCH_BLOCKS 16
+// Samples produced per batch (two points per block)
+#define MC_BATCH_SAMPLES (2 * MC_BATCH_BLOCKS)
+
+// Function to count the samples in [begin, end) of a stream that fall inside
+// the unit quarter circle. Streams with different ids never share a counter.
+inline long count_inside_circle(PhiloxKey key, uint32_t stream, uint64_t begin, uint64_t end) {
+    long inside = 0;
+    uint32_t bits[4][MC_BATCH_BLOCKS];
+
+    for (uint64_t base = begin - begin % MC_BATCH_SAMPLES; base < end; base += MC_BATCH_SAMPLES) {
+        philox4x32Batch<MC_BATCH_BLOCKS>(base / 2, stream, 0, key, bits);
+
+        if (base >= begin && base + MC_BATCH_SAMPLES <= end) {
+            // Full batch: branch-free so the loop vectorizes
+            for (int l = 0; l < MC_BATCH_BLOCKS; ++l) {
+                float x0 = uint32ToUnitFloat(bits[0][l]);
+                float y0 = uint32ToUnitFloat(bits[1][l]);
+                float x1 = uint32ToUnitFloat(bits[2][l]);
+                float y1 = uint32ToUnitFloat(bits[3][l]);
+                inside += (x0 * x0 + y0 * y0 <= 1.0f);
+                inside += (x1 * x1 + y1 * y1 <= 1.0f);
+            }
+        } else {
+            // Partial batch at either end of the range
+            for (int l = 0; l < MC_BATCH_BLOCKS; ++l) {
+                for (int half = 0; half < 2; ++half) {
+                    uint64_t sample = base + 2 * l + half;
+                    if (sample < begin || sample >= end) continue;
+                    float x = uint32ToUnitFloat(bits[2 * half][l]);
+                    float y = uint32ToUnitFloat(bits[2 * half + 1][l]);
+                    inside += (x * x + y * y <= 1.0f);
+                }
+            }
+        }
+    }
+
+    return inside;
+}
+
+#endif // MONTE_CARLO_ENGINE_H
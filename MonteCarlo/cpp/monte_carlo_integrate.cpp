@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <cmath>
+#include <cstdlib>
+
+#include "monte_carlo_integrate.h"
+
+// Built-in integrands with known exact values, used to check the engine and
+// compare sampling methods. Other integrands can be passed to integrate()
+// directly as any callable double(const double*, int).
+
+// Indicator of the unit ball on [-1, 1]^d: integrates to the ball's volume
+double unit_ball(const double* x, int dims) {
+    double r2 = 0.0;
+    for (int d = 0; d < dims; ++d) r2 += x[d] * x[d];
+    return r2 <= 1.0 ? 1.0 : 0.0;
+}
+
+// exp(-|x|^2) on [0, 1]^d
+double gaussian(const double* x, int dims) {
+    double r2 = 0.0;
+    for (int d = 0; d < dims; ++d) r2 += x[d] * x[d];
+    return std::exp(-r2);
+}
+
+// prod cos(x_i) on [0, 1]^d
+double cosine_product(const double* x, int dims) {
+    double p = 1.0;
+    for (int d = 0; d < dims; ++d) p *= std::cos(x[d]);
+    return p;
+}
+
+struct Problem {
+    const char* name;
+    double (*integrand)(const double*, int);
+    double lower;
+    double upper;
+    double (*exact)(int dims);
+};
+
+static const Problem kProblems[] = {
+    {"ball", unit_ball, -1.0, 1.0,
+     [](int d) { return std::pow(M_PI, d / 2.0) / std::tgamma(d / 2.0 + 1.0); }},
+    {"gaussian", gaussian, 0.0, 1.0,
+     [](int d) { return std::pow(std::sqrt(M_PI) / 2.0 * std::erf(1.0), d); }},
+    {"cosine", cosine_product, 0.0, 1.0,
+     [](int d) { return std::pow(std::sin(1.0), d); }},
+};
+
+int main(int argc, char* argv[]) {
+    IntegrationOptions options;
+    bool fixed_seed = false;
+    double target_width = 0.0;
+    double confidence = 0.95;
+
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--method=", 0) == 0) {
+            if (!parseSamplingMethod(arg.substr(9), options.method)) {
+                std::cerr << "Unknown sampling method " << arg.substr(9) << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = std::stoull(arg.substr(7));
+            fixed_seed = true;
+        } else if (arg.rfind("--replicates=", 0) == 0) {
+            options.sobol_replicates = std::stoi(arg.substr(13));
+        } else if (arg.rfind("--target-ci=", 0) == 0) {
+            target_width = std::stod(arg.substr(12));
+        } else if (arg.rfind("--confidence=", 0) == 0) {
+            confidence = std::stod(arg.substr(13));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 3 || args.size() > 4) {
+        std::cerr << "Usage: " << argv[0] << " <ball|gaussian|cosine> <dims> <num_samples> [num_threads]"
+                  << " [--method=plain|antithetic|stratified|sobol] [--seed=N] [--replicates=R]"
+                  << " [--target-ci=WIDTH] [--confidence=LEVEL]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const Problem* problem = nullptr;
+    for (const Problem& p : kProblems) {
+        if (args[0] == p.name) problem = &p;
+    }
+    if (problem == nullptr) {
+        std::cerr << "Unknown integrand " << args[0] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int dims = std::stoi(args[1]);
+    options.num_samples = std::stoull(args[2]);
+    int num_threads = (args.size() == 4) ? std::stoi(args[3]) : omp_get_max_threads();
+    if (dims <= 0 || dims > MC_MAX_DIMS || num_threads <= 0) {
+        std::cerr << "Dimensions must be in 1.." << MC_MAX_DIMS << " and threads positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+    omp_set_num_threads(num_threads);
+
+    if (!fixed_seed) {
+        std::random_device rd;
+        options.seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    IntegrationDomain domain = IntegrationDomain::cube(dims, problem->lower, problem->upper);
+    if (target_width < 0.0 || confidence <= 0.0 || confidence >= 1.0) {
+        std::cerr << "Target interval width must be positive and confidence in (0, 1)." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // With --target-ci, num_samples is only the budget
+    IntegrationResult result;
+    if (target_width > 0.0) {
+        result = integrate_adaptive(problem->integrand, domain, options, target_width, confidence);
+        if (result.samples == 0) {
+            std::cerr << "Adaptive mode supports the plain and antithetic methods only." << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        result = integrate(problem->integrand, domain, options);
+        if (result.samples == 0) {
+            std::cerr << "Options not supported for this problem (Sobol allows up to " << SOBOL_MAX_DIMS
+                      << " dimensions and needs at least 2 replicates)." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    double exact = problem->exact(dims);
+    std::cout << std::setprecision(10)
+              << "Estimate: " << result.estimate << "\n"
+              << "Standard error: " << result.std_error << "\n"
+              << "Exact: " << exact << "\n"
+              << "Absolute error: " << std::fabs(result.estimate - exact) << "\n"
+              << "Samples: " << result.samples << "\n"
+              << "Time (s): " << result.seconds << "\n"
+              << "Samples/sec: " << result.samples_per_sec << "\n"
+              << "Seed: " << options.seed << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,395 @@
+#ifndef MONTE_CARLO_INTEGRATE_H
+#define MONTE_CARLO_INTEGRATE_H
+
+// Monte Carlo integration of a user-supplied integrand over a box in up to
+// MC_MAX_DIMS dimensions.
+//
+// The integrand is any callable `double f(const double* x, int dims)`.
+// Supported sampling methods:
+//  - Plain:      independent uniform points.
+//  - Antithetic: each uniform point u is paired with 1 - u.
+//  - Stratified: the box is split into equal cells (along as many dimensions
+//                as the sample budget allows) with the same number of points
+//                in each cell.
+//  - Sobol:      randomized quasi-Monte Carlo. Independent random digital
+//                shifts of a Sobol sequence give replicate estimates, and the
+//                standard error comes from their spread.
+//
+// Random points come from Philox keyed by the seed and indexed by sample
+// number. Samples are processed in fixed-size chunks whose partial statistics
+// are merged in chunk order, so a given seed gives bit-identical results for
+// any thread count.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "../../common/philox.h"
+#include "monte_carlo_adaptive.h"
+#include "running_stats.h"
+#include "sobol.h"
+
+#define MC_MAX_DIMS 64
+// Samples per chunk; chunks are the unit of parallel work and of reduction
+#define MC_CHUNK_SAMPLES 4096
+// Samples whose uniforms are generated together
+#define MC_POINT_BATCH 16
+
+enum class SamplingMethod { Plain, Antithetic, Stratified, Sobol };
+
+// Function to parse a sampling method name
+inline bool parseSamplingMethod(const std::string& name, SamplingMethod& method) {
+    if (name == "plain") method = SamplingMethod::Plain;
+    else if (name == "antithetic") method = SamplingMethod::Antithetic;
+    else if (name == "stratified") method = SamplingMethod::Stratified;
+    else if (name == "sobol") method = SamplingMethod::Sobol;
+    else return false;
+    return true;
+}
+
+// Axis-aligned box [lower, upper]
+struct IntegrationDomain {
+    std::vector<double> lower;
+    std::vector<double> upper;
+
+    int dims() const { return static_cast<int>(lower.size()); }
+
+    double volume() const {
+        double v = 1.0;
+        for (int d = 0; d < dims(); ++d) v *= upper[d] - lower[d];
+        return v;
+    }
+
+    // Function to build the box [lo, hi]^dims
+    static IntegrationDomain cube(int dims, double lo, double hi) {
+        IntegrationDomain domain;
+        domain.lower.assign(dims, lo);
+        domain.upper.assign(dims, hi);
+        return domain;
+    }
+};
+
+struct IntegrationOptions {
+    SamplingMethod method = SamplingMethod::Plain;
+    uint64_t num_samples = 1000000;   // Integrand evaluations to spend
+    uint64_t seed = 0;
+    int sobol_replicates = 16;        // Random shifts used by Sobol
+};
+
+struct IntegrationResult {
+    double estimate = 0.0;
+    double std_error = 0.0;
+    uint64_t samples = 0;             // Integrand evaluations actually used
+    double seconds = 0.0;
+    double samples_per_sec = 0.0;
+};
+
+// Function to fill u[l][d] with uniforms in (0, 1) for samples
+// first .. first + count - 1 (count <= MC_POINT_BATCH). Word pair 2j of the
+// Philox block for counter {sample, j, stream} gives dimensions 2j and 2j + 1.
+inline void fill_uniforms(PhiloxKey key, uint32_t stream, uint64_t first, int count, int dims,
+                          double u[MC_POINT_BATCH][MC_MAX_DIMS]) {
+    uint32_t bits[4][MC_POINT_BATCH];
+    for (int j = 0; 2 * j < dims; ++j) {
+        philox4x32Batch<MC_POINT_BATCH>(first, static_cast<uint32_t>(j), stream, key, bits);
+        for (int l = 0; l < count; ++l) {
+            u[l][2 * j] = uint64ToUnitDouble((static_cast<uint64_t>(bits[0][l]) << 32) | bits[1][l]);
+            if (2 * j + 1 < dims) {
+                u[l][2 * j + 1] = uint64ToUnitDouble((static_cast<uint64_t>(bits[2][l]) << 32) | bits[3][l]);
+            }
+        }
+    }
+}
+
+// Function to map a point of the unit cube into the domain
+inline void to_domain(const IntegrationDomain& domain, const double* u, double* x) {
+    for (int d = 0; d < domain.dims(); ++d) {
+        x[d] = domain.lower[d] + u[d] * (domain.upper[d] - domain.lower[d]);
+    }
+}
+
+// Function to evaluate the integrand times the domain volume at samples
+// [begin, end) (Plain) or sample pairs [begin, end) (Antithetic)
+template <class Integrand>
+RunningStats sample_chunk(const Integrand& f, const IntegrationDomain& domain, PhiloxKey key,
+                          bool antithetic, uint64_t begin, uint64_t end) {
+    const int dims = domain.dims();
+    const double volume = domain.volume();
+    double u[MC_POINT_BATCH][MC_MAX_DIMS];
+    double mirrored[MC_MAX_DIMS];
+    double x[MC_MAX_DIMS];
+    RunningStats stats;
+
+    for (uint64_t first = begin; first < end; first += MC_POINT_BATCH) {
+        int count = static_cast<int>(std::min<uint64_t>(MC_POINT_BATCH, end - first));
+        fill_uniforms(key, 0, first, count, dims, u);
+        for (int l = 0; l < count; ++l) {
+            to_domain(domain, u[l], x);
+            double value = f(static_cast<const double*>(x), dims);
+            if (antithetic) {
+                for (int d = 0; d < dims; ++d) mirrored[d] = 1.0 - u[l][d];
+                to_domain(domain, mirrored, x);
+                value = 0.5 * (value + f(static_cast<const double*>(x), dims));
+            }
+            stats.add(value * volume);
+        }
+    }
+    return stats;
+}
+
+// Cell layout used by stratified sampling: `strata` cells along each of the
+// first `stratified_dims` dimensions, `per_cell` samples in each cell
+struct StratifiedLayout {
+    int stratified_dims = 0;
+    uint64_t strata = 1;
+    uint64_t cells = 1;
+    uint64_t per_cell = 0;
+};
+
+// Function to choose the finest stratification that still leaves at least
+// two samples per cell, which is needed to estimate the variance
+inline StratifiedLayout choose_strata(int dims, uint64_t num_samples) {
+    StratifiedLayout layout;
+    uint64_t max_cells = num_samples / 2;
+
+    uint64_t m = static_cast<uint64_t>(std::floor(std::pow(static_cast<double>(max_cells), 1.0 / dims)));
+    while (m > 1 && std::pow(static_cast<double>(m), dims) > static_cast<double>(max_cells)) m--;
+
+    if (m >= 2) {
+        layout.stratified_dims = dims;
+        layout.strata = m;
+    } else if (max_cells >= 2) {
+        // Too many dimensions for even two strata each: halve as many
+        // dimensions as the budget allows
+        layout.strata = 2;
+        while (layout.stratified_dims < dims && (2ull << layout.stratified_dims) <= max_cells) {
+            layout.stratified_dims++;
+        }
+    }
+
+    layout.cells = 1;
+    for (int d = 0; d < layout.stratified_dims; ++d) layout.cells *= layout.strata;
+    layout.per_cell = num_samples / layout.cells;
+    return layout;
+}
+
+// Function to sample cells [begin, end). Returns the sum of the cell means
+// and, in variance_sum, the sum of the variances of the cell means. The
+// samples of consecutive cells are consecutive, so the uniforms are drawn in
+// full batches across cell boundaries; with the usual few samples per cell,
+// a batch per cell would throw most of each Philox batch away.
+template <class Integrand>
+double stratified_chunk(const Integrand& f, const IntegrationDomain& domain, PhiloxKey key,
+                        const StratifiedLayout& layout, uint64_t begin, uint64_t end, double& variance_sum) {
+    const int dims = domain.dims();
+    const double volume = domain.volume();
+    const uint64_t last_sample = end * layout.per_cell;
+    uint64_t next_sample = begin * layout.per_cell;   // First sample not yet drawn
+    int buffered = 0;                                 // Uniforms in u
+    int used = 0;                                     // Of which already consumed
+    double u[MC_POINT_BATCH][MC_MAX_DIMS];
+    double x[MC_MAX_DIMS];
+    double mean_sum = 0.0;
+    variance_sum = 0.0;
+
+    for (uint64_t cell = begin; cell < end; ++cell) {
+        // Coordinates of the cell along the stratified dimensions
+        uint64_t coords[MC_MAX_DIMS];
+        uint64_t rest = cell;
+        for (int d = 0; d < layout.stratified_dims; ++d) {
+            coords[d] = rest % layout.strata;
+            rest /= layout.strata;
+        }
+
+        RunningStats stats;
+        for (uint64_t j = 0; j < layout.per_cell; ++j) {
+            if (used == buffered) {
+                buffered = static_cast<int>(std::min<uint64_t>(MC_POINT_BATCH, last_sample - next_sample));
+                fill_uniforms(key, 0, next_sample, buffered, dims, u);
+                next_sample += buffered;
+                used = 0;
+            }
+            double* point = u[used++];
+            for (int d = 0; d < layout.stratified_dims; ++d) {
+                point[d] = (coords[d] + point[d]) / layout.strata;
+            }
+            to_domain(domain, point, x);
+            stats.add(f(static_cast<const double*>(x), dims) * volume);
+        }
+
+        mean_sum += stats.mean;
+        variance_sum += stats.variance() / stats.n;
+    }
+    return mean_sum;
+}
+
+// Function to sum the integrand over points [begin, end) of one randomly
+// shifted Sobol sequence
+template <class Integrand>
+double sobol_chunk(const Integrand& f, const IntegrationDomain& domain, const SobolSequence& sobol,
+                   const uint32_t* shift, uint32_t begin, uint32_t end) {
+    const int dims = domain.dims();
+    uint32_t bits[SOBOL_MAX_DIMS];
+    double u[SOBOL_MAX_DIMS];
+    double x[SOBOL_MAX_DIMS];
+    double sum = 0.0;
+
+    sobol.point(begin, bits);
+    for (uint32_t i = begin; i < end; ++i) {
+        for (int d = 0; d < dims; ++d) {
+            u[d] = (static_cast<double>(bits[d] ^ shift[d]) + 0.5) * (1.0 / 4294967296.0);
+        }
+        to_domain(domain, u, x);
+        sum += f(static_cast<const double*>(x), dims);
+        if (i + 1 < end) sobol.next(i, bits);
+    }
+    return sum;
+}
+
+// Function to integrate f over the domain. Runs on the current OpenMP team
+// size (omp_set_num_threads). Returns a result with samples == 0 if the
+// options cannot be used with the domain.
+template <class Integrand>
+IntegrationResult integrate(const Integrand& f, const IntegrationDomain& domain, const IntegrationOptions& options) {
+    IntegrationResult result;
+    const int dims = domain.dims();
+    if (dims <= 0 || dims > MC_MAX_DIMS || options.num_samples < 2) return result;
+    if (options.method == SamplingMethod::Sobol &&
+        (dims > SOBOL_MAX_DIMS || options.sobol_replicates < 2 ||
+         options.num_samples / options.sobol_replicates >= 0xffffffffull)) {
+        return result;
+    }
+
+    const PhiloxKey key = philoxKeyFromSeed(options.seed);
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (options.method == SamplingMethod::Plain || options.method == SamplingMethod::Antithetic) {
+        bool antithetic = options.method == SamplingMethod::Antithetic;
+        uint64_t units = antithetic ? options.num_samples / 2 : options.num_samples;
+        uint64_t chunks = (units + MC_CHUNK_SAMPLES - 1) / MC_CHUNK_SAMPLES;
+        std::vector<RunningStats> partial(chunks);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (uint64_t c = 0; c < chunks; ++c) {
+            uint64_t end = std::min(units, (c + 1) * MC_CHUNK_SAMPLES);
+            partial[c] = sample_chunk(f, domain, key, antithetic, c * MC_CHUNK_SAMPLES, end);
+        }
+
+        RunningStats total;
+        for (const RunningStats& p : partial) total.merge(p);
+        result.estimate = total.mean;
+        result.std_error = std::sqrt(total.variance() / total.n);
+        result.samples = antithetic ? 2 * units : units;
+    } else if (options.method == SamplingMethod::Stratified) {
+        StratifiedLayout layout = choose_strata(dims, options.num_samples);
+        uint64_t cells_per_chunk = std::max<uint64_t>(1, MC_CHUNK_SAMPLES / layout.per_cell);
+        uint64_t chunks = (layout.cells + cells_per_chunk - 1) / cells_per_chunk;
+        std::vector<double> mean_sums(chunks), variance_sums(chunks);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (uint64_t c = 0; c < chunks; ++c) {
+            uint64_t end = std::min(layout.cells, (c + 1) * cells_per_chunk);
+            mean_sums[c] = stratified_chunk(f, domain, key, layout, c * cells_per_chunk, end, variance_sums[c]);
+        }
+
+        double mean_sum = 0.0, variance_sum = 0.0;
+        for (uint64_t c = 0; c < chunks; ++c) {
+            mean_sum += mean_sums[c];
+            variance_sum += variance_sums[c];
+        }
+        double cells = static_cast<double>(layout.cells);
+        result.estimate = mean_sum / cells;
+        result.std_error = std::sqrt(variance_sum) / cells;
+        result.samples = layout.cells * layout.per_cell;
+    } else {
+        SobolSequence sobol(dims);
+        const int replicates = options.sobol_replicates;
+        const uint32_t points = static_cast<uint32_t>(options.num_samples / replicates);
+        const uint64_t chunks_per_replicate = (points + MC_CHUNK_SAMPLES - 1) / MC_CHUNK_SAMPLES;
+
+        // Replicate r is shifted by the Philox block for counter {r, 0, 1}
+        std::vector<uint32_t> shifts(static_cast<size_t>(replicates) * SOBOL_MAX_DIMS);
+        for (int r = 0; r < replicates; ++r) {
+            for (int j = 0; j < dims; j += 4) {
+                uint32_t ctr[4] = {static_cast<uint32_t>(r), static_cast<uint32_t>(j), 1, 0};
+                uint32_t out[4];
+                philox4x32(ctr, key, out);
+                for (int w = 0; w < 4 && j + w < dims; ++w) shifts[r * SOBOL_MAX_DIMS + j + w] = out[w];
+            }
+        }
+
+        const uint64_t chunks = chunks_per_replicate * replicates;
+        std::vector<double> sums(chunks);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (uint64_t c = 0; c < chunks; ++c) {
+            uint64_t r = c / chunks_per_replicate;
+            uint64_t begin = (c % chunks_per_replicate) * MC_CHUNK_SAMPLES;
+            uint64_t end = std::min<uint64_t>(points, begin + MC_CHUNK_SAMPLES);
+            sums[c] = sobol_chunk(f, domain, sobol, &shifts[r * SOBOL_MAX_DIMS],
+                                  static_cast<uint32_t>(begin), static_cast<uint32_t>(end));
+        }
+
+        RunningStats replicate_stats;
+        const double volume = domain.volume();
+        for (int r = 0; r < replicates; ++r) {
+            double sum = 0.0;
+            for (uint64_t c = 0; c < chunks_per_replicate; ++c) sum += sums[r * chunks_per_replicate + c];
+            replicate_stats.add(sum / points * volume);
+        }
+        result.estimate = replicate_stats.mean;
+        result.std_error = std::sqrt(replicate_stats.variance() / replicates);
+        result.samples = static_cast<uint64_t>(points) * replicates;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.samples_per_sec = result.seconds > 0.0 ? result.samples / result.seconds : 0.0;
+    return result;
+}
+
+// Function to integrate with plain or antithetic sampling until the
+// confidence interval of the estimate is narrower than target_width, using at
+// most options.num_samples evaluations. Blocks are the same chunks the fixed
+// size run uses, claimed in order by whichever thread is free.
+template <class Integrand>
+IntegrationResult integrate_adaptive(const Integrand& f, const IntegrationDomain& domain, const IntegrationOptions& options,
+                                     double target_width, double confidence) {
+    IntegrationResult result;
+    const int dims = domain.dims();
+    if (dims <= 0 || dims > MC_MAX_DIMS || options.num_samples < 2 ||
+        (options.method != SamplingMethod::Plain && options.method != SamplingMethod::Antithetic)) {
+        return result;
+    }
+
+    const PhiloxKey key = philoxKeyFromSeed(options.seed);
+    const bool antithetic = options.method == SamplingMethod::Antithetic;
+    const uint64_t units = antithetic ? options.num_samples / 2 : options.num_samples;
+
+    AdaptiveOptions adaptive;
+    adaptive.target_width = target_width;
+    adaptive.confidence = confidence;
+    adaptive.max_blocks = (units + MC_CHUNK_SAMPLES - 1) / MC_CHUNK_SAMPLES;
+
+    auto sample_block = [&](uint64_t block) {
+        uint64_t end = std::min(units, (block + 1) * MC_CHUNK_SAMPLES);
+        return sample_chunk(f, domain, key, antithetic, block * MC_CHUNK_SAMPLES, end);
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    AdaptiveResult run = run_adaptive(sample_block, adaptive);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result.estimate = run.stats.mean;
+    result.std_error = run.stats.n > 1 ? std::sqrt(run.stats.variance() / run.stats.n) : 0.0;
+    result.samples = antithetic ? 2 * run.stats.n : run.stats.n;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.samples_per_sec = result.seconds > 0.0 ? result.samples / result.seconds : 0.0;
+    return result;
+}
+
+#endif // MONTE_CARLO_INTEGRATE_H
@@ -1,59 +1,221 @@
 #include <iostream>
+#include <iomanip>
 #include <random>
+#include <string>
+#include <vector>
 #include <omp.h>
 #include <cmath>
 #include <cstdlib>
 #include <chrono>
 
-double estimate_pi(long num_points) {
+#include "monte_carlo_adaptive.h"
+#include "monte_carlo_engine.h"
+#include "../../common/autotune.h"
+#include "../../common/perf_counters.h"
+#include "../../common/trace.h"
+
+#ifdef USE_WS_POOL
+#include "../../common/ws_pool.h"
+
+// Pool that runs the fixed-size estimate instead of OpenMP, created in main
+static WorkStealingPool* pool = nullptr;
+#endif
+
+// Samples per block in adaptive mode
+#define MC_ADAPTIVE_BLOCK (1 << 16)
+
+// Counter phase, reported when PERF_COUNTERS=1; traced under the same name
+static const int PHASE_SAMPLE = perfRegisterPhase("montecarlo.sample");
+
+double estimate_pi(long num_points, uint64_t seed) {
     long points_inside = 0;
+    PhiloxKey key = philoxKeyFromSeed(seed);
 
-    #pragma omp parallel
-    {
-        std::random_device rd;
-        std::mt19937 gen(rd() ^ (omp_get_thread_num() << 16));
-        std::uniform_real_distribution<double> dis(0.0, 1.0);
+    // Sample i is always generated from (seed, i); threads only decide which
+    // contiguous range of sample indices they evaluate. The count is an exact
+    // integer sum, so the estimate does not depend on the thread count.
+    const uint64_t total = static_cast<uint64_t>(num_points);
+    const uint64_t batches = (total + MC_BATCH_SAMPLES - 1) / MC_BATCH_SAMPLES;
 
-        #pragma omp for reduction(+:points_inside) schedule(static, 10000)
-        for (long i = 0; i < num_points; i++) {
-            double x = dis(gen);
-            double y = dis(gen);
+#ifdef USE_WS_POOL
+    // Ranges of whole batches; the count is still an exact integer sum
+    points_inside = pool->parallelReduce(0, static_cast<long>(batches), 0, 0L,
+        [&](long lo, long hi, int) {
+            PerfScope perf(PHASE_SAMPLE);
+            TRACE_SCOPE("montecarlo.sample");
+            uint64_t end = std::min<uint64_t>(total, hi * MC_BATCH_SAMPLES);
+            return count_inside_circle(key, 0, lo * MC_BATCH_SAMPLES, end);
+        },
+        [](long a, long b) { return a + b; });
+#else
+    #pragma omp parallel reduction(+:points_inside)
+    {
+        PerfScope perf(PHASE_SAMPLE);
+        TRACE_SCOPE("montecarlo.sample");
+        uint64_t thread_id = omp_get_thread_num();
+        uint64_t thread_count = omp_get_num_threads();
 
-            if (x * x + y * y <= 1.0) {
-                points_inside++;
-            }
+        // Ranges are aligned to whole batches so no thread generates a
+        // partial batch except at the very end
+        uint64_t begin = batches * thread_id / thread_count * MC_BATCH_SAMPLES;
+        uint64_t end = batches * (thread_id + 1) / thread_count * MC_BATCH_SAMPLES;
+        if (end > total) end = total;
+        if (begin < end) {
+            points_inside += count_inside_circle(key, 0, begin, end);
         }
     }
+#endif
 
     return 4.0 * static_cast<double>(points_inside) / static_cast<double>(num_points);
 }
 
+// Function to estimate pi until the confidence interval is narrower than
+// target_width, drawing at most max_points samples. Block b holds samples
+// [b * MC_ADAPTIVE_BLOCK, (b + 1) * MC_ADAPTIVE_BLOCK), still generated from
+// (seed, i).
+AdaptiveResult estimate_pi_adaptive(long max_points, uint64_t seed, double target_width, double confidence) {
+    PhiloxKey key = philoxKeyFromSeed(seed);
+    const uint64_t total = static_cast<uint64_t>(max_points);
+
+    AdaptiveOptions options;
+    options.target_width = target_width;
+    options.confidence = confidence;
+    options.max_blocks = (total + MC_ADAPTIVE_BLOCK - 1) / MC_ADAPTIVE_BLOCK;
+
+    auto sample_block = [&](uint64_t block) {
+        PerfScope perf(PHASE_SAMPLE);
+        TRACE_SCOPE("montecarlo.sample");
+        uint64_t begin = block * MC_ADAPTIVE_BLOCK;
+        uint64_t end = std::min<uint64_t>(total, begin + MC_ADAPTIVE_BLOCK);
+        double inside = static_cast<double>(count_inside_circle(key, 0, begin, end));
+
+        // Each sample contributes 4 if inside and 0 otherwise
+        RunningStats stats;
+        stats.n = end - begin;
+        stats.mean = 4.0 * inside / stats.n;
+        stats.m2 = 16.0 * inside * (1.0 - inside / stats.n);
+        return stats;
+    };
+
+    return run_adaptive(sample_block, options);
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2 || argc > 3) {
-        std::cerr << "Usage: " << argv[0] << " <num_points> [num_threads]" << std::endl;
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    bool fixed_seed = false;
+    uint64_t seed = 0;
+    double target_width = 0.0;
+    double confidence = 0.95;
+    AutotuneMode autotune = AutotuneMode::Cache;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (parseAutotuneFlag(arg, autotune)) {
+            continue;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::stoull(arg.substr(7));
+            fixed_seed = true;
+        } else if (arg.rfind("--target-ci=", 0) == 0) {
+            target_width = std::stod(arg.substr(12));
+        } else if (arg.rfind("--confidence=", 0) == 0) {
+            confidence = std::stod(arg.substr(13));
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 1 || args.size() > 2) {
+        std::cerr << "Usage: " << argv[0] << " <num_points> [num_threads] [--seed=N]"
+                  << " [--target-ci=WIDTH] [--confidence=LEVEL] [--autotune[=off]]" << std::endl;
         return EXIT_FAILURE;
     }
 
-    long num_points = std::stol(argv[1]);
+    long num_points = std::stol(args[0]);
     if (num_points <= 0) {
         std::cerr << "Number of points must be positive." << std::endl;
         return EXIT_FAILURE;
     }
 
-    int num_threads = (argc == 3) ? std::stoi(argv[2]) : omp_get_max_threads();
+    int num_threads = (args.size() == 2) ? std::stoi(args[1]) : omp_get_max_threads();
     if (num_threads <= 0) {
         std::cerr << "Number of threads must be positive." << std::endl;
         return EXIT_FAILURE;
     }
 
+    if (target_width < 0.0 || confidence <= 0.0 || confidence >= 1.0) {
+        std::cerr << "Target interval width must be positive and confidence in (0, 1)." << std::endl;
+        return EXIT_FAILURE;
+    }
+
     omp_set_num_threads(num_threads);
 
+#ifdef USE_WS_POOL
+    WorkStealingPool workers(num_threads);
+    pool = &workers;
+#endif
+
+    // Without --seed every run draws a fresh seed; it is printed so that any
+    // run can be repeated exactly
+    if (!fixed_seed) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    // With --target-ci, num_points is only the budget: sampling stops as soon
+    // as the confidence interval is narrower than the target
+    if (target_width > 0.0) {
+        auto start = std::chrono::high_resolution_clock::now();
+        AdaptiveResult result = estimate_pi_adaptive(num_points, seed, target_width, confidence);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        std::cout << duration.count()<< std::endl;
+        std::cerr << "Seed: " << seed << std::endl;
+        std::cerr << "Estimated pi: " << std::setprecision(17) << result.stats.mean << std::endl;
+        std::cerr << "Samples used: " << result.stats.n << std::endl;
+        std::cerr << "Confidence interval (" << confidence * 100 << "%): +/- " << result.half_width
+                  << (result.reached_target ? "" : " (budget exhausted before target)") << std::endl;
+        perfReport(std::cerr);
+        TRACE_WRITE();
+        return EXIT_SUCCESS;
+    }
+
+#ifndef USE_WS_POOL
+    // Without a thread count, the team size of the fixed-size estimate is
+    // searched with --autotune and otherwise taken from the cache. The
+    // samples are split into batch-aligned ranges by hand, so there is no
+    // schedule to tune. Tuning runs are dropped from the counters and the
+    // trace.
+    if (args.size() < 2 && autotune != AutotuneMode::Off) {
+        Autotuner tuner("monte_carlo_par", num_points);
+        tuner.addParam("threads", autotuneThreadCandidates(), num_threads);
+        if (autotune == AutotuneMode::Tune) {
+            tuner.tune([&]() {
+                omp_set_num_threads((int)tuner.get("threads"));
+                estimate_pi(num_points, seed);
+            }, std::cerr);
+            perfReset();
+            traceReset();
+        } else if (tuner.load()) {
+            std::cerr << "Autotune: using " << tuner.describe() << " from " << tuner.path() << std::endl;
+        }
+        omp_set_num_threads((int)tuner.get("threads"));
+    }
+#else
+    // The pool keeps the given number of workers
+    if (autotune == AutotuneMode::Tune) std::cerr << "Autotune: pool builds are not tuned" << std::endl;
+#endif
+
     auto start = std::chrono::high_resolution_clock::now();
-    double pi_estimate = estimate_pi(num_points);
+    double pi_estimate = estimate_pi(num_points, seed);
     auto end = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     std::cout << duration.count()<< std::endl;
+    std::cerr << "Seed: " << seed << std::endl;
+    std::cerr << "Estimated pi: " << std::setprecision(17) << pi_estimate << std::endl;
+    perfReport(std::cerr);
+    TRACE_WRITE();
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
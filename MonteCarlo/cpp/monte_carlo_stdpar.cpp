@@ -0,0 +1,88 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <execution>
+#include <numeric>
+
+#include "monte_carlo_engine.h"
+#include "../../common/stdpar_util.h"
+
+// Compilation Instructions:
+// g++ -O3 -std=c++17 -o monte_carlo_stdpar monte_carlo_stdpar.cpp -ltbb
+
+double estimate_pi(long num_points, uint64_t seed) {
+    PhiloxKey key = philoxKeyFromSeed(seed);
+
+    // One element per batch of samples; sample i is still generated from
+    // (seed, i) and the count is an exact integer sum, so the estimate is the
+    // same as the sequential and OpenMP versions for any thread count
+    const uint64_t total = static_cast<uint64_t>(num_points);
+    const long batches = static_cast<long>((total + MC_BATCH_SAMPLES - 1) / MC_BATCH_SAMPLES);
+
+    long points_inside = std::transform_reduce(std::execution::par, CountingIterator(0), CountingIterator(batches),
+        0L, std::plus<long>(),
+        [=](long batch) {
+            uint64_t begin = static_cast<uint64_t>(batch) * MC_BATCH_SAMPLES;
+            uint64_t end = std::min<uint64_t>(total, begin + MC_BATCH_SAMPLES);
+            return count_inside_circle(key, 0, begin, end);
+        });
+
+    return 4.0 * static_cast<double>(points_inside) / static_cast<double>(num_points);
+}
+
+int main(int argc, char* argv[]) {
+    // Split the --options from the positional arguments
+    std::vector<std::string> args;
+    bool fixed_seed = false;
+    uint64_t seed = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::stoull(arg.substr(7));
+            fixed_seed = true;
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 1 || args.size() > 2) {
+        std::cerr << "Usage: " << argv[0] << " <num_points> [num_threads] [--seed=N]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    long num_points = std::stol(args[0]);
+    if (num_points <= 0) {
+        std::cerr << "Number of points must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int num_threads = (args.size() == 2) ? std::stoi(args[1]) : 0;
+    if (args.size() == 2 && num_threads <= 0) {
+        std::cerr << "Number of threads must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+    ParallelismLimit limit(num_threads);
+
+    // Without --seed every run draws a fresh seed; it is printed so that any
+    // run can be repeated exactly
+    if (!fixed_seed) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    double pi_estimate = estimate_pi(num_points, seed);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    std::cout << duration.count()<< std::endl;
+    std::cerr << "Seed: " << seed << std::endl;
+    std::cerr << "Estimated pi: " << std::setprecision(17) << pi_estimate << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+#ifndef RUNNING_STATS_H
+#define RUNNING_STATS_H
+
+#include <cstdint>
+
+// Mean and sum of squared deviations of a set of values (Welford), with the
+// pairwise merge of Chan et al. for combining partial results
+struct RunningStats {
+    uint64_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double x) {
+        n++;
+        double delta = x - mean;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+    }
+
+    void merge(const RunningStats& other) {
+        if (other.n == 0) return;
+        if (n == 0) {
+            *this = other;
+            return;
+        }
+        uint64_t total = n + other.n;
+        double delta = other.mean - mean;
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * (static_cast<double>(n) * other.n / total);
+        n = total;
+    }
+
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+};
+
+#endif // RUNNING_STATS_H
@@ -0,0 +1,92 @@
+#ifndef SOBOL_H
+#define SOBOL_H
+
+// Sobol low-discrepancy sequence in up to SOBOL_MAX_DIMS dimensions, using
+// the primitive polynomials and initial direction numbers of Joe and Kuo
+// ("Constructing Sobol sequences with better two-dimensional projections",
+// SIAM J. Sci. Comput. 30, 2008). Points are 32-bit: x = bits * 2^-32.
+
+#include <cstdint>
+
+#define SOBOL_MAX_DIMS 16
+#define SOBOL_BITS 32
+
+// Degree s, polynomial coefficients a and initial m_1..m_s for dimensions
+// 2..SOBOL_MAX_DIMS; dimension 1 is the van der Corput sequence
+struct SobolPolynomial {
+    int s;
+    uint32_t a;
+    uint32_t m[6];
+};
+
+static const SobolPolynomial kSobolPolynomials[SOBOL_MAX_DIMS - 1] = {
+    {1, 0,  {1}},
+    {2, 1,  {1, 3}},
+    {3, 1,  {1, 3, 1}},
+    {3, 2,  {1, 1, 1}},
+    {4, 1,  {1, 1, 3, 3}},
+    {4, 4,  {1, 3, 5, 13}},
+    {5, 2,  {1, 1, 5, 5, 17}},
+    {5, 4,  {1, 1, 5, 5, 5}},
+    {5, 7,  {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1,  {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+};
+
+class SobolSequence {
+public:
+    explicit SobolSequence(int dims) : dims_(dims) {
+        // Dimension 1: V_k = 2^(32 - k)
+        for (int k = 0; k < SOBOL_BITS; ++k) {
+            v_[0][k] = 1u << (SOBOL_BITS - 1 - k);
+        }
+
+        for (int d = 1; d < dims_; ++d) {
+            const SobolPolynomial& p = kSobolPolynomials[d - 1];
+            for (int k = 0; k < SOBOL_BITS; ++k) {
+                if (k < p.s) {
+                    v_[d][k] = p.m[k] << (SOBOL_BITS - 1 - k);
+                } else {
+                    uint32_t v = v_[d][k - p.s] ^ (v_[d][k - p.s] >> p.s);
+                    for (int i = 1; i < p.s; ++i) {
+                        if ((p.a >> (p.s - 1 - i)) & 1u) v ^= v_[d][k - i];
+                    }
+                    v_[d][k] = v;
+                }
+            }
+        }
+    }
+
+    int dims() const { return dims_; }
+
+    // Function to compute point `index` directly from its Gray code
+    void point(uint32_t index, uint32_t x[]) const {
+        uint32_t gray = index ^ (index >> 1);
+        for (int d = 0; d < dims_; ++d) {
+            uint32_t value = 0;
+            for (int k = 0; gray >> k; ++k) {
+                if ((gray >> k) & 1u) value ^= v_[d][k];
+            }
+            x[d] = value;
+        }
+    }
+
+    // Function to turn point `index` in x into point `index + 1`
+    void next(uint32_t index, uint32_t x[]) const {
+        int c = 0;
+        while ((index >> c) & 1u) ++c;
+        for (int d = 0; d < dims_; ++d) {
+            x[d] ^= v_[d][c];
+        }
+    }
+
+private:
+    int dims_;
+    uint32_t v_[SOBOL_MAX_DIMS][SOBOL_BITS];
+};
+
+#endif // SOBOL_H
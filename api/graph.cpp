@@ -0,0 +1,72 @@
+#include <omp.h>
+#include <algorithm>
+#include <new>
+
+#include "kernels.h"
+
+// Candidates per thread in the partial minima, one cache line each
+#define PARTIAL_STRIDE (64 / sizeof(DenseCandidate<ShortestPath::Distance>))
+
+// Vertices per unit of work: one word of the visited bitmap, as in
+// dijkstra_par, so every thread's range stays aligned for the vector kernel
+#define SSSP_BLOCK 64
+
+Graph Graph::random(long vertices, unsigned int seed) {
+    Graph graph;
+    if (!graph.dense_.allocate(vertices)) throw std::bad_alloc();
+    graph.dense_.generateRandom(seed);
+    return graph;
+}
+
+const ShortestPath::Distance ShortestPath::kUnreachable;
+
+ShortestPath::ShortestPath(int num_threads) : num_threads_(num_threads) {}
+
+const std::vector<ShortestPath::Distance>& ShortestPath::run(const Graph& graph, long source) {
+    const long n = graph.vertices();
+    dist_.assign(n, kUnreachable);
+    visited_.reset(n);
+    if (source < 0 || source >= n) return dist_;
+    dist_[source] = 0;
+
+    const int threads = num_threads_ > 0 ? num_threads_ : omp_get_max_threads();
+    partials_.assign((size_t)threads * PARTIAL_STRIDE, DenseCandidate<Distance>());
+
+    const long blocks = (n + SSSP_BLOCK - 1) / SSSP_BLOCK;
+    Distance* dist = dist_.data();
+    DenseCandidate<Distance>* partials = partials_.data();
+    long u = source;
+    visited_.set(u);
+
+    // One parallel region for the whole run. Each iteration every thread
+    // relaxes the row of u over its own run of blocks and finds its closest
+    // unvisited vertex in the same pass (relaxRowAndFindMin); after a
+    // barrier one thread combines the candidates and marks the next u.
+    #pragma omp parallel num_threads(threads)
+    {
+        const long tid = omp_get_thread_num();
+        const long team = omp_get_num_threads();
+        const long lo = std::min(n, blocks * tid / team * SSSP_BLOCK);
+        const long hi = std::min(n, blocks * (tid + 1) / team * SSSP_BLOCK);
+
+        for (long count = 0; count < n - 1; count++) {
+            DenseCandidate<Distance> local;
+            relaxRowAndFindMin(graph.row(u), dist[u], dist, visited_.words(), lo, hi, local);
+            partials[tid * PARTIAL_STRIDE] = local;
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                DenseCandidate<Distance> best;
+                for (long t = 0; t < team; t++) best.merge(partials[t * PARTIAL_STRIDE]);
+                u = best.vertex;
+                if (u >= 0) visited_.set(u);
+            }
+
+            // Every thread sees the same u after the single's barrier
+            if (u < 0) break;
+        }
+    }
+
+    return dist_;
+}
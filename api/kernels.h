@@ -0,0 +1,196 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+// Library API for the four kernels, for callers that run many jobs in one
+// process instead of exec'ing a benchmark binary per job.
+//
+// Data (Graph, Matrix, the points held by KMeans) is loaded once and can be
+// reused across calls. The context objects (ShortestPath, MatrixMultiplier,
+// KMeans, MonteCarlo) own their scratch buffers and keep them between calls,
+// reallocating only when the problem size changes. All kernels run on
+// OpenMP; the runtime keeps its thread team alive between parallel regions,
+// so as long as a context is used with the same thread count no threads are
+// created per call.
+//
+//   Graph graph = Graph::random(5000, 42);
+//   ShortestPath sp(8);
+//   const std::vector<ShortestPath::Distance>& dist = sp.run(graph, 0);
+//
+// Graphs are the DenseGraph<int32_t> of the Dijkstra binaries
+// (Dijkstra/cpp/dense_graph.h), generated the same way, and ShortestPath
+// runs their fused relaxation kernel (dense_relax.h), so a graph of a given
+// size and seed has the same distances here as in dijkstra_par. KMeans runs
+// the assignment kernels of kmeans_omp_par (direct or GEMM) over the same
+// workspace, so with the same thread count it reaches the same clustering.
+//
+// Functions that read or write files return false and fill in error on
+// failure. A context must not be used by two threads at the same time; use
+// one context per worker thread instead.
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../Dijkstra/cpp/dense_graph.h"
+#include "../Dijkstra/cpp/dense_relax.h"
+#include "../kmeans/cpp/kmeans_workspace.h"
+
+// Dense weighted graph with int32 weights; weight 0 means no edge
+class Graph {
+public:
+    Graph() {}
+
+    // Function to build a random undirected graph with weights in [0, 9]
+    // (DenseGraph::generateRandom, as in the Dijkstra binaries). Throws
+    // std::bad_alloc if the matrix cannot be allocated.
+    static Graph random(long vertices, unsigned int seed);
+
+    // Function to read a graph from a "n n" header followed by n x n weights
+    // (the matrix input format)
+    bool load(const std::string& path, std::string& error) { return dense_.load(path, error); }
+
+    long vertices() const { return dense_.size(); }
+    int32_t weight(long u, long v) const { return dense_.weight(u, v); }
+    void setWeight(long u, long v, int32_t w) { dense_.setWeight(u, v, w); }
+    const int32_t* row(long u) const { return dense_.row(u); }
+    const DenseGraph<int32_t>& dense() const { return dense_; }
+
+private:
+    DenseGraph<int32_t> dense_;
+};
+
+// Reusable single-source shortest path context (Dijkstra)
+class ShortestPath {
+public:
+    typedef DenseGraph<int32_t>::Distance Distance;
+
+    // Distance reported for vertices the source cannot reach
+    static const Distance kUnreachable = std::numeric_limits<Distance>::max();
+
+    // num_threads <= 0 uses the OpenMP default
+    explicit ShortestPath(int num_threads = 0);
+
+    // Function to compute the distances from source to every vertex. The
+    // returned vector is owned by the context and valid until the next run.
+    const std::vector<Distance>& run(const Graph& graph, long source);
+
+    const std::vector<Distance>& distances() const { return dist_; }
+    int numThreads() const { return num_threads_; }
+
+private:
+    int num_threads_;
+    std::vector<Distance> dist_;
+    VisitedSet visited_;
+    std::vector<DenseCandidate<Distance> > partials_;   // Per-thread minima, one cache line each
+};
+
+// Dense row-major integer matrix
+class Matrix {
+public:
+    Matrix() : rows_(0), cols_(0) {}
+    Matrix(int rows, int cols) : rows_(rows), cols_(cols), data_((long)rows * cols, 0) {}
+
+    // Function to read a matrix from a "rows cols" header followed by values
+    bool load(const std::string& path, std::string& error);
+    // Function to write a matrix in the same format
+    bool save(const std::string& path, std::string& error) const;
+
+    // Function to change the shape; storage is kept when it is large enough
+    void resize(int rows, int cols);
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int& at(int i, int j) { return data_[(long)i * cols_ + j]; }
+    int at(int i, int j) const { return data_[(long)i * cols_ + j]; }
+    int* row(int i) { return data_.data() + (long)i * cols_; }
+    const int* row(int i) const { return data_.data() + (long)i * cols_; }
+
+private:
+    int rows_;
+    int cols_;
+    std::vector<int> data_;
+};
+
+// Reusable matrix multiplication context
+class MatrixMultiplier {
+public:
+    // num_threads <= 0 uses the OpenMP default
+    explicit MatrixMultiplier(int num_threads = 0);
+
+    // Function to compute C = A * B; C is reshaped (reusing its storage when
+    // possible). Returns false if the shapes do not match.
+    bool multiply(const Matrix& A, const Matrix& B, Matrix& C, std::string& error);
+
+    int numThreads() const { return num_threads_; }
+
+private:
+    int num_threads_;
+};
+
+// Reusable K-means context: holds the points and the KMeansWorkspace of
+// kmeans_omp_par (kmeans/cpp/kmeans_workspace.h), which is reallocated only
+// when the number of points, dimensions, clusters or threads changes
+class KMeans {
+public:
+    // num_threads <= 0 uses the OpenMP default
+    explicit KMeans(int num_threads = 0, AssignMode mode = AssignMode::Direct);
+
+    // Function to read points from the K-means input format
+    // (kmeans/cpp/kmeans_input.h), in any number of dimensions
+    bool load(const std::string& path, std::string& error);
+    // Function to copy n points of dims coordinates each, stored point by point
+    void setPoints(const float* coords, long n, int dims = 2);
+
+    // Function to cluster the loaded points into k clusters, starting from
+    // the first k points. max_iterations <= 0 runs until no assignment
+    // changes. Returns the number of iterations, or -1 if there are fewer
+    // points than clusters.
+    int run(int k, int max_iterations = 0);
+
+    // Function to write the result in the format of the K-means binaries
+    bool save(const std::string& path, std::string& error) const;
+
+    long numPoints() const { return (long)points_.size() / dims_; }
+    int dims() const { return dims_; }
+    const std::vector<float>& points() const { return points_; }    // n x dims
+    int numClusters() const { return ws_.K; }
+    int iterations() const { return iterations_; }
+    // Results of the last run, valid until the next one
+    const float* centroids() const { return ws_.centroids; }        // k x dims
+    const int* assignments() const { return ws_.clusters; }         // Cluster per point
+    int numThreads() const { return num_threads_; }
+    AssignMode assignMode() const { return mode_; }
+
+private:
+    bool assign();
+
+    int num_threads_;
+    AssignMode mode_;
+    int dims_;
+    int iterations_;
+    bool points_changed_;          // points_ not yet copied into the workspace
+    std::vector<float> points_;
+    KMeansWorkspace ws_;
+};
+
+// Reusable Monte Carlo pi estimation context. Sample i is generated from
+// (seed, i) by a counter-based generator, so estimates are reproducible and
+// do not depend on the thread count.
+class MonteCarlo {
+public:
+    // num_threads <= 0 uses the OpenMP default
+    explicit MonteCarlo(int num_threads = 0);
+
+    // Function to count the samples in [0, samples) inside the quarter circle
+    long countInside(long samples, uint64_t seed);
+    // Function to estimate pi from the given number of samples
+    double estimatePi(long samples, uint64_t seed);
+
+    int numThreads() const { return num_threads_; }
+
+private:
+    int num_threads_;
+};
+
+#endif // KERNELS_H
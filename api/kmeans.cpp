@@ -0,0 +1,134 @@
+#include <omp.h>
+#include <algorithm>
+#include <fstream>
+
+#include "kernels.h"
+#include "../kmeans/cpp/kmeans_input.h"
+
+KMeans::KMeans(int num_threads, AssignMode mode)
+    : num_threads_(num_threads), mode_(mode), dims_(2), iterations_(0), points_changed_(true) {}
+
+bool KMeans::load(const std::string& path, std::string& error) {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        error = "Unable to open input file " + path;
+        return false;
+    }
+
+    long n = 0;
+    int d = 2;
+    if (!readKMeansHeader(input, n, d, error)) {
+        error = "Input file " + path + ": " + error;
+        return false;
+    }
+
+    std::vector<float> points(n * d);
+    for (long i = 0; i < n * d; i++) {
+        input >> points[i];
+    }
+    if (!input) {
+        error = "Input file " + path + " is truncated";
+        return false;
+    }
+    points_.swap(points);
+    dims_ = d;
+    points_changed_ = true;
+    return true;
+}
+
+void KMeans::setPoints(const float* coords, long n, int dims) {
+    points_.assign(coords, coords + n * dims);
+    dims_ = dims;
+    points_changed_ = true;
+}
+
+int KMeans::run(int k, int max_iterations) {
+    const long n = numPoints();
+    if (k <= 0 || n < k) return -1;
+
+    const int threads = num_threads_ > 0 ? num_threads_ : omp_get_max_threads();
+    KMeansWorkspace& ws = ws_;
+
+    // Repeated runs of the same shape reuse the workspace, and the points
+    // are only copied into it when they changed
+    if (ws.N != n || ws.D != dims_ || ws.K != k || ws.num_threads != threads || !ws.points) {
+        ws.allocate(n, dims_, k, threads, mode_);
+        points_changed_ = true;
+    }
+    if (points_changed_) {
+        std::copy(points_.begin(), points_.end(), ws.points);
+        if (mode_ == AssignMode::Gemm) {
+            #pragma omp parallel for num_threads(threads) schedule(static)
+            for (long i = 0; i < n; i++) {
+                ws.point_norms[i] = pointNorm(ws, i);
+            }
+        }
+        points_changed_ = false;
+    }
+
+    // Initialize centroids with the first k points
+    std::copy(ws.points, ws.points + (long)k * ws.D, ws.centroids);
+    std::fill(ws.clusters, ws.clusters + n, -1);
+
+    iterations_ = 0;
+    bool changed = true;
+    while (changed && (max_iterations <= 0 || iterations_ < max_iterations)) {
+        changed = assign();
+        reduceCentroids(ws);
+        iterations_++;
+    }
+    return iterations_;
+}
+
+// Function to assign every point to its closest centroid, each thread
+// taking a contiguous block and accumulating its clusters into its own
+// slice of the partial sums, as in kmeans_omp_par
+bool KMeans::assign() {
+    KMeansWorkspace& ws = ws_;
+    const long n = ws.N;
+    bool changed = false;
+
+    if (mode_ == AssignMode::Gemm) prepareGemmCentroids(ws);
+
+    // Cleared up front rather than by each thread, so slices of threads the
+    // runtime did not start cannot hold stale sums
+    std::fill(ws.sums, ws.sums + (long)ws.num_threads * ws.sums_stride, 0.0);
+    std::fill(ws.counts, ws.counts + (long)ws.num_threads * ws.sums_stride, 0L);
+
+    #pragma omp parallel num_threads(ws.num_threads) reduction(||:changed)
+    {
+        const long tid = omp_get_thread_num();
+        const long team = omp_get_num_threads();
+        double* sums = ws.sums + tid * ws.sums_stride;
+        long* counts = ws.counts + tid * ws.sums_stride;
+        changed = assignRangeWith(ws, mode_, n * tid / team, n * (tid + 1) / team, sums, counts, (int)tid);
+    }
+    return changed;
+}
+
+bool KMeans::save(const std::string& path, std::string& error) const {
+    std::ofstream output(path);
+    if (!output.is_open()) {
+        error = "Unable to open output file " + path;
+        return false;
+    }
+
+    const KMeansWorkspace& ws = ws_;
+    output << "Total Iterations: " << iterations_ << "\n";
+    output << "Number of Points: " << ws.N << "\n";
+    output << "Centroids:\n";
+    for (int j = 0; j < ws.K; j++) {
+        for (int d = 0; d < ws.D; d++) {
+            if (d > 0) output << ", ";
+            output << ws.centroids[IDX(j, d, ws.D)];
+        }
+        output << "\n";
+    }
+    output << "Point Assignments:\n";
+    for (long i = 0; i < ws.N; i++) {
+        output << ws.clusters[i];
+        if (i < ws.N - 1) output << " ";
+    }
+    output << "\n";
+    return true;
+}
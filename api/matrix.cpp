@@ -0,0 +1,85 @@
+#include <omp.h>
+#include <algorithm>
+#include <fstream>
+
+#include "kernels.h"
+
+bool Matrix::load(const std::string& path, std::string& error) {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        error = "Unable to open matrix file " + path;
+        return false;
+    }
+
+    int rows = 0, cols = 0;
+    input >> rows >> cols;
+    if (!input || rows <= 0 || cols <= 0) {
+        error = "Matrix file " + path + " has an invalid size";
+        return false;
+    }
+
+    resize(rows, cols);
+    for (long i = 0; i < (long)rows * cols; i++) {
+        input >> data_[i];
+    }
+    if (!input) {
+        error = "Matrix file " + path + " is truncated";
+        return false;
+    }
+    return true;
+}
+
+bool Matrix::save(const std::string& path, std::string& error) const {
+    std::ofstream output(path);
+    if (!output.is_open()) {
+        error = "Unable to open file " + path;
+        return false;
+    }
+
+    output << rows_ << " " << cols_ << "\n";
+    for (int i = 0; i < rows_; i++) {
+        for (int j = 0; j < cols_; j++) {
+            output << at(i, j) << " ";
+        }
+        output << "\n";
+    }
+    return true;
+}
+
+void Matrix::resize(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    data_.resize((long)rows * cols);
+}
+
+MatrixMultiplier::MatrixMultiplier(int num_threads) : num_threads_(num_threads) {}
+
+bool MatrixMultiplier::multiply(const Matrix& A, const Matrix& B, Matrix& C, std::string& error) {
+    if (A.cols() != B.rows()) {
+        error = "Matrix shapes do not match for multiplication";
+        return false;
+    }
+
+    const int rows = A.rows();
+    const int cols = B.cols();
+    const int common_dim = A.cols();
+    const int threads = num_threads_ > 0 ? num_threads_ : omp_get_max_threads();
+    C.resize(rows, cols);
+
+    // Rows of C are independent; the i-k-j order streams through rows of B
+    // and C with unit stride
+    #pragma omp parallel for num_threads(threads) schedule(static)
+    for (int i = 0; i < rows; i++) {
+        int* c = C.row(i);
+        std::fill(c, c + cols, 0);
+        const int* a = A.row(i);
+        for (int k = 0; k < common_dim; k++) {
+            const int a_ik = a[k];
+            const int* b = B.row(k);
+            for (int j = 0; j < cols; j++) {
+                c[j] += a_ik * b[j];
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+#include <omp.h>
+#include <cstdint>
+
+#include "kernels.h"
+#include "../MonteCarlo/cpp/monte_carlo_engine.h"
+
+MonteCarlo::MonteCarlo(int num_threads) : num_threads_(num_threads) {}
+
+long MonteCarlo::countInside(long samples, uint64_t seed) {
+    if (samples <= 0) return 0;
+
+    PhiloxKey key = philoxKeyFromSeed(seed);
+    const uint64_t total = static_cast<uint64_t>(samples);
+    const uint64_t batches = (total + MC_BATCH_SAMPLES - 1) / MC_BATCH_SAMPLES;
+    const int threads = num_threads_ > 0 ? num_threads_ : omp_get_max_threads();
+    long inside = 0;
+
+    // Same split as monte_carlo_par: contiguous runs of whole batches per
+    // thread, and an exact integer sum
+    #pragma omp parallel num_threads(threads) reduction(+:inside)
+    {
+        uint64_t thread_id = omp_get_thread_num();
+        uint64_t thread_count = omp_get_num_threads();
+        uint64_t begin = batches * thread_id / thread_count * MC_BATCH_SAMPLES;
+        uint64_t end = batches * (thread_id + 1) / thread_count * MC_BATCH_SAMPLES;
+        if (end > total) end = total;
+        if (begin < end) {
+            inside += count_inside_circle(key, 0, begin, end);
+        }
+    }
+    return inside;
+}
+
+double MonteCarlo::estimatePi(long samples, uint64_t seed) {
+    if (samples <= 0) return 0.0;
+    return 4.0 * static_cast<double>(countInside(samples, seed)) / static_cast<double>(samples);
+}
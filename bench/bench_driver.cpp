@@ -0,0 +1,340 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../common/bench.h"
+
+// Benchmark driver for all four algorithms.
+//
+// Every binary in the repo times its own kernel and prints the elapsed
+// microseconds as the first number on stdout. The driver runs each selected
+// (algorithm, variant, size, threads) configuration with warmup runs and
+// repeated trials, reads that number back and reports min / median / p95 /
+// stddev plus the speedup over the matching sequential variant.
+//
+// Usage:
+//   bench_driver [--algorithms=dijkstra,matrix,kmeans,montecarlo]
+//                [--variants=cpp-seq,cpp-par,cpp-pool,cpp-stdpar,rust-seq,rust-par]
+//                [--sizes=N,...] [--threads=2,4,8,16,32]
+//                [--warmup=1] [--trials=5] [--clusters=10]
+//                [--format=table|json|csv] [--output=FILE]
+//                [--root=DIR] [--cpp-bin-dir=DIR]
+
+using namespace std;
+
+struct DriverConfig {
+    vector<string> algorithms = {"dijkstra", "matrix", "kmeans", "montecarlo"};
+    vector<string> variants = {"cpp-seq", "cpp-par"};
+    vector<long> sizes;                  // Empty means each algorithm's defaults
+    vector<long> threads = {2, 4, 8, 16, 32};
+    int warmup = 1;
+    int trials = 5;
+    int clusters = 10;
+    string format = "table";
+    string output;
+    string root = ".";
+    string cpp_bin_dir;                  // Empty means <Algorithm>/cpp/
+    string scratch_dir = "/tmp";
+};
+
+// Per-algorithm layout: directories, binary names and default sizes
+struct AlgorithmInfo {
+    const char* name;
+    const char* dir;
+    const char* cpp_seq;
+    const char* cpp_par;
+    const char* cpp_stdpar;
+    const char* rust_seq;
+    const char* rust_par;
+    vector<long> default_sizes;
+};
+
+static const vector<AlgorithmInfo> kAlgorithms = {
+    {"dijkstra", "Dijkstra", "dijkstra_seq", "dijkstra_par", "dijkstra_stdpar", "dijkstra_seq", "dijkstra_par",
+     {100, 1000, 5000}},
+    {"matrix", "Matrix_Multiplication", "MatrixMultiply_cpp_seq", "MatrixMultiply_omp_par", "MatrixMultiply_stdpar",
+     "MatrixMultiply_rs_seq", "MatrixMultiply_rs_par", {100, 500, 1000}},
+    {"kmeans", "kmeans", "kmeans_cpp_seq", "kmeans_omp_par", "kmeans_stdpar", "kmeans_rs_seq", "kmeans_rs_par",
+     {10000, 100000, 1000000}},
+    {"montecarlo", "MonteCarlo", "monte_carlo_seq", "monte_carlo_par", "monte_carlo_stdpar", "monte_carlo_seq",
+     "monte_carlo_par", {1000000, 10000000, 100000000}},
+};
+
+// Function to check whether a variant runs on several threads
+bool isParallel(const string& variant) {
+    return !(variant.size() > 4 && variant.compare(variant.size() - 3, 3, "seq") == 0);
+}
+
+// Function to check whether a file exists
+bool fileExists(const string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// Function to run a shell command and capture its stdout. Returns the exit
+// status, or -1 if the command could not be started.
+int runCommand(const string& command, string& output) {
+    output.clear();
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) return -1;
+
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, n);
+    }
+    int status = pclose(pipe);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Function to find the first line of output that is a single number
+bool parseMicroseconds(const string& output, double& micros) {
+    size_t start = 0;
+    while (start < output.size()) {
+        size_t end = output.find('\n', start);
+        if (end == string::npos) end = output.size();
+        string line = output.substr(start, end - start);
+        start = end + 1;
+
+        char* rest = nullptr;
+        double value = strtod(line.c_str(), &rest);
+        if (rest != line.c_str()) {
+            while (*rest == ' ' || *rest == '\t' || *rest == '\r') rest++;
+            if (*rest == '\0') {
+                micros = value;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Function to make a path absolute, so it stays valid after a cd
+string absolutePath(const string& path) {
+    if (path.empty() || path[0] == '/') return path;
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr) return path;
+    return string(cwd) + "/" + path;
+}
+
+// Function to locate an input generator: next to the C++ binaries when they
+// are built out of tree (CMake puts everything in build/bin), otherwise in
+// the algorithm's directory
+string generatorCommand(const DriverConfig& config, const string& name) {
+    if (config.cpp_bin_dir.empty()) return "./" + name;
+    return "'" + absolutePath(config.cpp_bin_dir) + "/" + name + "'";
+}
+
+// Function to make sure the input files of a size exist, running the
+// algorithm's generator if needed
+bool ensureInputs(const DriverConfig& config, const AlgorithmInfo& alg, long size, string& error) {
+    string dir = config.root + "/" + alg.dir;
+    string n = to_string(size);
+    string command;
+
+    if (string(alg.name) == "matrix") {
+        if (fileExists(dir + "/matrix1_" + n + ".txt") && fileExists(dir + "/matrix2_" + n + ".txt")) return true;
+        command = "cd '" + dir + "' && " + generatorCommand(config, "generate_matrix_input") + " " + n;
+    } else if (string(alg.name) == "kmeans") {
+        if (fileExists(dir + "/input_" + n + ".txt")) return true;
+        command = "cd '" + dir + "' && " + generatorCommand(config, "generate_kmeans_input") + " " + n;
+    } else {
+        return true;
+    }
+
+    string output;
+    if (runCommand(command + " 2>&1", output) != 0) {
+        error = "input generation failed: " + command;
+        return false;
+    }
+    return true;
+}
+
+// Function to build the command line for one run
+string buildCommand(const DriverConfig& config, const AlgorithmInfo& alg, const string& variant,
+                    long size, int threads) {
+    bool rust = variant.rfind("rust", 0) == 0;
+    bool parallel = isParallel(variant);
+    string binary_name = rust ? (parallel ? alg.rust_par : alg.rust_seq) : (parallel ? alg.cpp_par : alg.cpp_seq);
+
+    // cpp-pool is the parallel kernel built with -DUSE_WS_POOL
+    if (variant == "cpp-pool") binary_name += "_pool";
+    // cpp-stdpar is the std::execution version of the kernel
+    if (variant == "cpp-stdpar") binary_name = alg.cpp_stdpar;
+
+    string binary;
+    if (rust) {
+        binary = config.root + "/" + alg.dir + "/rust/target/release/" + binary_name;
+    } else if (!config.cpp_bin_dir.empty()) {
+        binary = config.cpp_bin_dir + "/" + binary_name;
+    } else {
+        binary = config.root + "/" + alg.dir + "/cpp/" + binary_name;
+    }
+
+    string dir = config.root + "/" + alg.dir;
+    string n = to_string(size);
+    string t = to_string(threads);
+    string scratch = config.scratch_dir + "/bench_" + alg.name + "_" + variant + "_" + n + ".out";
+
+    string args;
+    if (string(alg.name) == "dijkstra" || string(alg.name) == "montecarlo") {
+        args = n;
+        if (parallel) args += " " + t;
+    } else if (string(alg.name) == "matrix") {
+        args = "'" + dir + "/matrix1_" + n + ".txt' '" + dir + "/matrix2_" + n + ".txt' '" + scratch + "'";
+        if (parallel) args += " " + t;
+    } else {
+        args = "'" + dir + "/input_" + n + ".txt' '" + scratch + "' " + to_string(config.clusters);
+        if (parallel) args += " " + t;
+    }
+
+    string env = "OMP_NUM_THREADS=" + t + " RAYON_NUM_THREADS=" + t + " ";
+    return env + "'" + binary + "' " + args + " 2>/dev/null";
+}
+
+// Function to measure one configuration
+BenchRecord measure(const DriverConfig& config, const AlgorithmInfo& alg, const string& variant,
+                    long size, int threads) {
+    BenchRecord record;
+    record.algorithm = alg.name;
+    record.variant = variant;
+    record.size = size;
+    record.threads = threads;
+
+    if (!ensureInputs(config, alg, size, record.error)) {
+        record.ok = false;
+        return record;
+    }
+
+    string command = buildCommand(config, alg, variant, size, threads);
+    auto run_once = [&]() -> double {
+        string output;
+        double micros;
+        int status = runCommand(command, output);
+        if (status != 0) {
+            record.error = "exit status " + to_string(status) + ": " + command;
+            return -1.0;
+        }
+        if (!parseMicroseconds(output, micros)) {
+            record.error = "no timing in output: " + command;
+            return -1.0;
+        }
+        return micros;
+    };
+
+    record.samples = runTrials(run_once, config.warmup, config.trials, record.ok);
+    record.stats = computeStats(record.samples);
+    return record;
+}
+
+// Function to fill in speedups against the sequential variant of the same
+// language, algorithm and size
+void computeSpeedups(vector<BenchRecord>& records) {
+    map<string, double> baseline;
+    for (const BenchRecord& r : records) {
+        if (r.ok && r.variant.size() > 4 && r.variant.compare(r.variant.size() - 3, 3, "seq") == 0) {
+            string language = r.variant.substr(0, r.variant.size() - 4);
+            baseline[r.algorithm + "/" + language + "/" + to_string(r.size)] = r.stats.median;
+        }
+    }
+    for (BenchRecord& r : records) {
+        string language = r.variant.substr(0, r.variant.find('-'));
+        auto it = baseline.find(r.algorithm + "/" + language + "/" + to_string(r.size));
+        if (r.ok && it != baseline.end() && r.stats.median > 0.0) {
+            r.speedup = it->second / r.stats.median;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    DriverConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string value = (eq == string::npos) ? "" : arg.substr(eq + 1);
+
+        if (key == "--algorithms") config.algorithms = parseNameList(value);
+        else if (key == "--variants") config.variants = parseNameList(value);
+        else if (key == "--sizes") config.sizes = parseLongList(value);
+        else if (key == "--threads") config.threads = parseLongList(value);
+        else if (key == "--warmup") config.warmup = stoi(value);
+        else if (key == "--trials") config.trials = stoi(value);
+        else if (key == "--clusters") config.clusters = stoi(value);
+        else if (key == "--format") config.format = value;
+        else if (key == "--output") config.output = value;
+        else if (key == "--root") config.root = value;
+        else if (key == "--cpp-bin-dir") config.cpp_bin_dir = value;
+        else if (key == "--scratch-dir") config.scratch_dir = value;
+        else {
+            cerr << "Usage: " << argv[0] << " [--algorithms=dijkstra,matrix,kmeans,montecarlo]"
+                 << " [--variants=cpp-seq,cpp-par,cpp-pool,cpp-stdpar,rust-seq,rust-par] [--sizes=N,...] [--threads=T,...]"
+                 << " [--warmup=W] [--trials=R] [--clusters=K] [--format=table|json|csv] [--output=FILE]"
+                 << " [--root=DIR] [--cpp-bin-dir=DIR] [--scratch-dir=DIR]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (config.trials <= 0 || config.warmup < 0) {
+        cerr << "Error: trials must be positive and warmup non-negative." << endl;
+        return EXIT_FAILURE;
+    }
+    if (config.format != "table" && config.format != "json" && config.format != "csv") {
+        cerr << "Error: Unknown format " << config.format << endl;
+        return EXIT_FAILURE;
+    }
+
+    vector<BenchRecord> records;
+    for (const string& name : config.algorithms) {
+        const AlgorithmInfo* alg = nullptr;
+        for (const AlgorithmInfo& a : kAlgorithms) {
+            if (name == a.name) alg = &a;
+        }
+        if (alg == nullptr) {
+            cerr << "Error: Unknown algorithm " << name << endl;
+            return EXIT_FAILURE;
+        }
+
+        const vector<long>& sizes = config.sizes.empty() ? alg->default_sizes : config.sizes;
+        for (long size : sizes) {
+            for (const string& variant : config.variants) {
+                bool parallel = isParallel(variant);
+                vector<long> thread_counts = parallel ? config.threads : vector<long>{1};
+                for (long threads : thread_counts) {
+                    cerr << "[bench] " << name << " " << variant << " size=" << size
+                         << " threads=" << threads << endl;
+                    records.push_back(measure(config, *alg, variant, size, static_cast<int>(threads)));
+                }
+            }
+        }
+    }
+
+    computeSpeedups(records);
+
+    ofstream file;
+    if (!config.output.empty()) {
+        file.open(config.output);
+        if (!file.is_open()) {
+            cerr << "Error: Unable to open output file " << config.output << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    ostream& out = config.output.empty() ? cout : file;
+
+    if (config.format == "json") writeJson(records, out);
+    else if (config.format == "csv") writeCsv(records, out);
+    else writeTable(records, out);
+
+    for (const BenchRecord& r : records) {
+        if (!r.ok) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
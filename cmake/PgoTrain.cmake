@@ -0,0 +1,73 @@
+# PGO training run, invoked by the pgo-train target:
+#   cmake -DPGO_RUNS_FILE=... -DWORK_DIR=... -DMATRIX_GENERATOR=... -DKMEANS_GENERATOR=... -P PgoTrain.cmake
+#
+# Generates inputs with the repo's generators and runs every instrumented
+# kernel once on them, so each kernel's hot loops write a profile. Sizes are
+# kept moderate: the profile only needs representative branch and loop
+# counts, not benchmark-scale runs.
+
+set(PGO_THREADS 2)
+set(PGO_DIJKSTRA_SIZE 2000)
+set(PGO_MATRIX_SIZE 300)
+set(PGO_KMEANS_POINTS 100000)
+set(PGO_KMEANS_CLUSTERS 10)
+set(PGO_MONTECARLO_SAMPLES 10000000)
+
+include(${PGO_RUNS_FILE})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+# Function to run one command in the work directory and stop on failure
+function(pgo_run)
+    execute_process(COMMAND ${ARGN}
+                    WORKING_DIRECTORY ${WORK_DIR}
+                    RESULT_VARIABLE result
+                    OUTPUT_QUIET ERROR_QUIET)
+    if(NOT result EQUAL 0)
+        string(REPLACE ";" " " command "${ARGN}")
+        message(FATAL_ERROR "PGO training command failed (${result}): ${command}")
+    endif()
+endfunction()
+
+# Training inputs, generated once
+set(matrix1 ${WORK_DIR}/matrix1_${PGO_MATRIX_SIZE}.txt)
+set(matrix2 ${WORK_DIR}/matrix2_${PGO_MATRIX_SIZE}.txt)
+if(NOT EXISTS ${matrix1} OR NOT EXISTS ${matrix2})
+    pgo_run(${MATRIX_GENERATOR} ${PGO_MATRIX_SIZE} --seed=1)
+endif()
+set(kmeans_input ${WORK_DIR}/input_${PGO_KMEANS_POINTS}.txt)
+if(NOT EXISTS ${kmeans_input})
+    pgo_run(${KMEANS_GENERATOR} ${PGO_KMEANS_POINTS} --seed=1)
+endif()
+
+foreach(run IN LISTS PGO_RUNS)
+    string(FIND "${run}" "=" split)
+    string(SUBSTRING "${run}" 0 ${split} kind)
+    math(EXPR split "${split} + 1")
+    string(SUBSTRING "${run}" ${split} -1 binary)
+    get_filename_component(name ${binary} NAME)
+    message(STATUS "PGO training: ${name}")
+
+    # Sequential binaries ignore the thread count they do not take
+    if(name MATCHES "seq")
+        set(threads "")
+    else()
+        set(threads ${PGO_THREADS})
+    endif()
+
+    if(kind STREQUAL "dijkstra")
+        pgo_run(${binary} ${PGO_DIJKSTRA_SIZE} ${threads})
+    elseif(kind STREQUAL "dynamic")
+        pgo_run(${binary} ${PGO_DIJKSTRA_SIZE} --rounds=2 --seed=1)
+    elseif(kind STREQUAL "reorder")
+        pgo_run(${binary} ${PGO_DIJKSTRA_SIZE} --density=0.1 --band=100 --repeat=1 --seed=1)
+    elseif(kind STREQUAL "matrix")
+        pgo_run(${binary} ${matrix1} ${matrix2} ${WORK_DIR}/matrix_out.txt ${threads})
+    elseif(kind STREQUAL "kmeans")
+        pgo_run(${binary} ${kmeans_input} ${WORK_DIR}/kmeans_out.txt ${PGO_KMEANS_CLUSTERS} ${threads})
+    elseif(kind STREQUAL "montecarlo")
+        pgo_run(${binary} ${PGO_MONTECARLO_SAMPLES} ${threads} --seed=1)
+    elseif(kind STREQUAL "integrate")
+        pgo_run(${binary} ball 4 ${PGO_MONTECARLO_SAMPLES} ${threads} --seed=1)
+        pgo_run(${binary} gaussian 8 ${PGO_MONTECARLO_SAMPLES} ${threads} --method=sobol --seed=1)
+    endif()
+endforeach()
@@ -0,0 +1,352 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+// Auto-tuning of run-time parameters: thread counts, OpenMP schedules and
+// block sizes, per kernel and problem size on the current machine.
+//
+//   Autotuner tuner("matrix", n);
+//   tuner.addParam("threads", autotuneThreadCandidates(), 1);
+//   tuner.addSchedule();                     // "schedule" and "chunk"
+//   if (tune) tuner.tune([&]() { ...one run with tuner.get(...)... }, cerr);
+//   else tuner.load();                       // cached configuration, if any
+//   tuner.applySchedule();                   // for schedule(runtime) loops
+//
+// Binaries take --autotune to search, --autotune=off to ignore the cache,
+// and otherwise use the cached configuration when there is one.
+//
+// The search is coordinate descent: starting from the defaults (or the
+// cached configuration), each parameter in turn is set to every candidate
+// with the others fixed and the fastest is kept, until a sweep changes
+// nothing. After one untimed warm-up run, a configuration is timed as the
+// best of AUTOTUNE_REPEAT runs and never timed twice.
+//
+// The best configuration is cached in $AUTOTUNE_CACHE, by default
+// ${XDG_CACHE_HOME:-$HOME/.cache}/openmpvsrust-autotune.txt, one line per CPU
+// model, kernel and size range (sizes in [2^k, 2^(k+1)) share a line):
+//
+//   <cpu model>\t<kernel>\t<2^k>\t<name>=<value>,...\t<microseconds>
+//
+// The kernel name carries the build variant (autotuneVariant()), e.g.
+// kmeans_gemm_pool_native, since the pool, -march and PGO builds of a
+// kernel need not share their best configuration.
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+// Timed runs per configuration (the fastest counts)
+#ifndef AUTOTUNE_REPEAT
+#define AUTOTUNE_REPEAT 3
+#endif
+#define AUTOTUNE_MAX_SWEEPS 4
+
+// What a binary does with its tunable parameters: use the cached
+// configuration if there is one (default), search and save a new one
+// (--autotune), or keep the built-in defaults (--autotune=off)
+enum class AutotuneMode { Cache, Tune, Off };
+
+// Function to parse an --autotune flag; returns false if arg is not one
+inline bool parseAutotuneFlag(const std::string& arg, AutotuneMode& mode) {
+    if (arg == "--autotune") mode = AutotuneMode::Tune;
+    else if (arg == "--autotune=off") mode = AutotuneMode::Off;
+    else if (arg == "--autotune=cache") mode = AutotuneMode::Cache;
+    else return false;
+    return true;
+}
+
+// One tunable parameter; labels, when given, name the values in the cache
+struct AutotuneParam {
+    std::string name;
+    std::vector<long> values;
+    std::vector<std::string> labels;
+    long value;
+
+    std::string format(long v) const {
+        for (size_t i = 0; i < labels.size() && i < values.size(); i++) {
+            if (values[i] == v) return labels[i];
+        }
+        return std::to_string(v);
+    }
+
+    bool parse(const std::string& text, long& v) const {
+        for (size_t i = 0; i < labels.size() && i < values.size(); i++) {
+            if (labels[i] == text) {
+                v = values[i];
+                return true;
+            }
+        }
+        char* end = nullptr;
+        v = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0';
+    }
+};
+
+// Function to name the CPU: the model from /proc/cpuinfo and the number of
+// hardware threads
+inline std::string autotuneCpuModel() {
+    std::string model = "unknown cpu";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0 && line.find(':') != std::string::npos) {
+            model = line.substr(line.find(':') + 1);
+            model.erase(0, model.find_first_not_of(' '));
+            break;
+        }
+    }
+    std::replace(model.begin(), model.end(), '\t', ' ');
+    return model + " (" + std::to_string(std::thread::hardware_concurrency()) + " threads)";
+}
+
+// Function to name the build variant: AUTOTUNE_VARIANT when the build sets
+// it (CMake does, from the pool, -march and PGO settings of the target),
+// otherwise what the compiler predefines
+inline std::string autotuneVariant() {
+#ifdef AUTOTUNE_VARIANT
+    return AUTOTUNE_VARIANT;
+#else
+    std::string variant;
+#ifdef USE_WS_POOL
+    variant += "_pool";
+#endif
+#if defined(__AVX512F__)
+    variant += "_avx512";
+#elif defined(__AVX2__)
+    variant += "_avx2";
+#endif
+    return variant.empty() ? variant : variant.substr(1);
+#endif
+}
+
+// Function to get the cache file path
+inline std::string autotuneCachePath() {
+    const char* env = std::getenv("AUTOTUNE_CACHE");
+    if (env != nullptr && env[0] != '\0') return env;
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg != nullptr && xdg[0] != '\0') return std::string(xdg) + "/openmpvsrust-autotune.txt";
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && home[0] != '\0') return std::string(home) + "/.cache/openmpvsrust-autotune.txt";
+    return "openmpvsrust-autotune.txt";
+}
+
+// Function to list thread counts worth trying: powers of two up to the
+// number of processors, and that number itself
+inline std::vector<long> autotuneThreadCandidates() {
+    const long procs = std::max(1, omp_get_num_procs());
+    std::vector<long> values;
+    for (long t = 1; t < procs; t *= 2) values.push_back(t);
+    values.push_back(procs);
+    return values;
+}
+
+class Autotuner {
+public:
+    Autotuner(const std::string& kernel, long size)
+        : kernel_(kernel), cpu_(autotuneCpuModel()), path_(autotuneCachePath()), best_us_(0.0) {
+        const std::string variant = autotuneVariant();
+        if (!variant.empty()) kernel_ += "_" + variant;
+        bucket_ = 1;
+        while (bucket_ <= size / 2) bucket_ *= 2;
+    }
+
+    // Function to add a parameter with its candidate values and the value
+    // used when nothing is tuned or cached
+    void addParam(const std::string& name, const std::vector<long>& values, long initial,
+                  const std::vector<std::string>& labels = std::vector<std::string>()) {
+        AutotuneParam param;
+        param.name = name;
+        param.values = values;
+        param.labels = labels;
+        param.value = initial;
+        params_.push_back(param);
+    }
+
+    // Function to add the "schedule" (static, dynamic, guided) and "chunk"
+    // (0 = the runtime default) of the schedule(runtime) loops, initially
+    // the given kind with its default chunk
+    void addSchedule(omp_sched_t initial = omp_sched_static) {
+        addParam("schedule", {omp_sched_static, omp_sched_dynamic, omp_sched_guided}, initial,
+                 {"static", "dynamic", "guided"});
+        addParam("chunk", {0, 1, 16, 256, 4096}, 0);
+    }
+
+    bool has(const std::string& name) const { return find(name) != nullptr; }
+    long get(const std::string& name) const {
+        const AutotuneParam* param = find(name);
+        return param != nullptr ? param->value : 0;
+    }
+    bool empty() const { return params_.empty(); }
+    const std::string& path() const { return path_; }
+
+    // Function to set the OpenMP schedule used by schedule(runtime) loops
+    void applySchedule() const {
+        if (has("schedule")) omp_set_schedule((omp_sched_t)get("schedule"), (int)get("chunk"));
+    }
+
+    // Function to format the configuration as name=value,...
+    std::string describe() const {
+        std::string text;
+        for (const AutotuneParam& param : params_) {
+            if (!text.empty()) text += ",";
+            text += param.name + "=" + param.format(param.value);
+        }
+        return text;
+    }
+
+    // Function to load the cached configuration for this CPU, kernel and
+    // size range. Parameters the entry does not mention keep their values.
+    // Returns false if there is no entry.
+    bool load() {
+        std::ifstream input(path_);
+        std::string line;
+        while (std::getline(input, line)) {
+            std::vector<std::string> fields = split(line, '\t');
+            if (fields.size() != 5 || fields[0] != cpu_ || fields[1] != kernel_ ||
+                fields[2] != std::to_string(bucket_)) {
+                continue;
+            }
+            for (const std::string& entry : split(fields[3], ',')) {
+                size_t eq = entry.find('=');
+                if (eq == std::string::npos) continue;
+                AutotuneParam* param = find(entry.substr(0, eq));
+                long value;
+                if (param != nullptr && param->parse(entry.substr(eq + 1), value)) param->value = value;
+            }
+            best_us_ = std::atof(fields[4].c_str());
+            return true;
+        }
+        return false;
+    }
+
+    // Function to search the parameters with run() (which must use the
+    // current values) and save the fastest configuration. Progress goes to
+    // log. Returns the best time in microseconds.
+    template <class Run>
+    double tune(Run run, std::ostream& log) {
+        load();
+        std::map<std::string, double> timed;
+        auto measure = [&]() {
+            const std::string key = describe();
+            auto it = timed.find(key);
+            if (it != timed.end()) return it->second;
+            double best = HUGE_VAL;
+            for (int r = 0; r < AUTOTUNE_REPEAT; r++) {
+                auto start = std::chrono::steady_clock::now();
+                run();
+                std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            log << "Autotune: " << (key.empty() ? "(no parameters)" : key) << ": " << best << " us" << std::endl;
+            timed[key] = best;
+            return best;
+        };
+
+        // One untimed run first, so the first configuration does not pay
+        // for page faults and cold caches
+        run();
+        double best = measure();
+        for (int sweep = 0; sweep < AUTOTUNE_MAX_SWEEPS; sweep++) {
+            bool changed = false;
+            for (AutotuneParam& param : params_) {
+                const long start = param.value;
+                long keep = start;
+                for (long value : param.values) {
+                    if (value == start) continue;
+                    param.value = value;
+                    double t = measure();
+                    if (t < best) {
+                        best = t;
+                        keep = value;
+                        changed = true;
+                    }
+                }
+                param.value = keep;
+            }
+            if (!changed) break;
+        }
+
+        best_us_ = best;
+        if (save()) {
+            log << "Autotune: best " << describe() << " (" << best << " us), saved to " << path_ << std::endl;
+        } else {
+            log << "Autotune: best " << describe() << " (" << best << " us); unable to write " << path_ << std::endl;
+        }
+        return best;
+    }
+
+    // Function to replace this CPU, kernel and size range's line in the cache
+    // file. The file is rewritten through a temporary and renamed, so readers
+    // never see it half written.
+    bool save() const {
+        std::vector<std::string> lines;
+        {
+            std::ifstream input(path_);
+            std::string line;
+            while (std::getline(input, line)) {
+                std::vector<std::string> fields = split(line, '\t');
+                if (fields.size() == 5 && fields[0] == cpu_ && fields[1] == kernel_ &&
+                    fields[2] == std::to_string(bucket_)) {
+                    continue;
+                }
+                if (!line.empty()) lines.push_back(line);
+            }
+        }
+        std::ostringstream entry;
+        entry << cpu_ << "\t" << kernel_ << "\t" << bucket_ << "\t" << describe() << "\t" << best_us_;
+        lines.push_back(entry.str());
+
+        size_t slash = path_.rfind('/');
+        if (slash != std::string::npos && slash > 0) mkdir(path_.substr(0, slash).c_str(), 0755);
+
+        const std::string temp = path_ + ".tmp";
+        {
+            std::ofstream output(temp, std::ios::trunc);
+            if (!output.is_open()) return false;
+            for (const std::string& line : lines) output << line << "\n";
+            if (!output) return false;
+        }
+        return std::rename(temp.c_str(), path_.c_str()) == 0;
+    }
+
+private:
+    static std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> fields;
+        std::stringstream stream(text);
+        std::string field;
+        while (std::getline(stream, field, separator)) fields.push_back(field);
+        return fields;
+    }
+
+    AutotuneParam* find(const std::string& name) {
+        for (AutotuneParam& param : params_) {
+            if (param.name == name) return &param;
+        }
+        return nullptr;
+    }
+    const AutotuneParam* find(const std::string& name) const {
+        for (const AutotuneParam& param : params_) {
+            if (param.name == name) return &param;
+        }
+        return nullptr;
+    }
+
+    std::string kernel_;
+    std::string cpu_;
+    std::string path_;
+    long bucket_;
+    double best_us_;
+    std::vector<AutotuneParam> params_;
+};
+
+#endif // AUTOTUNE_H
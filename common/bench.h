@@ -0,0 +1,202 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Benchmark statistics and report writers shared by the benchmark driver and
+// any binary that times its own repeated runs.
+//
+// A measurement is a list of per-trial times in microseconds, taken after a
+// number of untimed warmup runs. Reports carry min / median / p95 / mean /
+// stddev so that a regression can be told apart from run-to-run noise.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchStats {
+    size_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double stddev = 0.0;   // Sample standard deviation
+};
+
+// Function to compute the q-quantile (0 <= q <= 1) of sorted samples with
+// linear interpolation between closest ranks
+inline double quantile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    double pos = q * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(pos));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+}
+
+// Function to summarize a list of samples
+inline BenchStats computeStats(std::vector<double> samples) {
+    BenchStats stats;
+    stats.count = samples.size();
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = quantile(samples, 0.5);
+    stats.p95 = quantile(samples, 0.95);
+
+    double sum = 0.0;
+    for (double s : samples) sum += s;
+    stats.mean = sum / samples.size();
+
+    double sq = 0.0;
+    for (double s : samples) sq += (s - stats.mean) * (s - stats.mean);
+    stats.stddev = samples.size() > 1 ? std::sqrt(sq / (samples.size() - 1)) : 0.0;
+    return stats;
+}
+
+// Function to run fn() warmup times untimed, then trials times, collecting
+// the time each call reports (in microseconds). fn returns a negative value
+// on failure, which stops the measurement and is reported via ok.
+template <class Fn>
+std::vector<double> runTrials(Fn fn, int warmup, int trials, bool& ok) {
+    std::vector<double> samples;
+    ok = true;
+    for (int i = 0; i < warmup; ++i) {
+        if (fn() < 0.0) {
+            ok = false;
+            return samples;
+        }
+    }
+    for (int i = 0; i < trials; ++i) {
+        double t = fn();
+        if (t < 0.0) {
+            ok = false;
+            return samples;
+        }
+        samples.push_back(t);
+    }
+    return samples;
+}
+
+// One benchmark configuration and its measurements
+struct BenchRecord {
+    std::string algorithm;
+    std::string variant;
+    long size = 0;
+    int threads = 1;
+    std::vector<double> samples;   // Microseconds per trial
+    BenchStats stats;
+    double speedup = 0.0;          // Baseline median / this median, 0 if none
+    bool ok = true;
+    std::string error;
+};
+
+// Function to escape a string for a JSON document
+inline std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// Function to write records as a JSON array
+inline void writeJson(const std::vector<BenchRecord>& records, std::ostream& out) {
+    out << std::setprecision(10) << "[\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const BenchRecord& r = records[i];
+        out << "  {\"algorithm\": \"" << jsonEscape(r.algorithm) << "\""
+            << ", \"variant\": \"" << jsonEscape(r.variant) << "\""
+            << ", \"size\": " << r.size
+            << ", \"threads\": " << r.threads
+            << ", \"ok\": " << (r.ok ? "true" : "false");
+        if (!r.ok) out << ", \"error\": \"" << jsonEscape(r.error) << "\"";
+        out << ", \"trials\": " << r.stats.count
+            << ", \"min_us\": " << r.stats.min
+            << ", \"median_us\": " << r.stats.median
+            << ", \"p95_us\": " << r.stats.p95
+            << ", \"mean_us\": " << r.stats.mean
+            << ", \"stddev_us\": " << r.stats.stddev
+            << ", \"max_us\": " << r.stats.max
+            << ", \"speedup\": " << r.speedup
+            << ", \"samples_us\": [";
+        for (size_t j = 0; j < r.samples.size(); ++j) {
+            out << (j ? ", " : "") << r.samples[j];
+        }
+        out << "]}" << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Function to write records as CSV with a header row
+inline void writeCsv(const std::vector<BenchRecord>& records, std::ostream& out) {
+    out << std::setprecision(10)
+        << "algorithm,variant,size,threads,ok,trials,min_us,median_us,p95_us,mean_us,stddev_us,max_us,speedup\n";
+    for (const BenchRecord& r : records) {
+        out << r.algorithm << "," << r.variant << "," << r.size << "," << r.threads << ","
+            << (r.ok ? 1 : 0) << "," << r.stats.count << ","
+            << r.stats.min << "," << r.stats.median << "," << r.stats.p95 << ","
+            << r.stats.mean << "," << r.stats.stddev << "," << r.stats.max << ","
+            << r.speedup << "\n";
+    }
+}
+
+// Function to write records as an aligned human-readable table
+inline void writeTable(const std::vector<BenchRecord>& records, std::ostream& out) {
+    out << std::left << std::setw(12) << "Algorithm" << std::setw(10) << "Variant"
+        << std::right << std::setw(10) << "Size" << std::setw(8) << "Threads"
+        << std::setw(14) << "Median (us)" << std::setw(14) << "Min (us)"
+        << std::setw(14) << "P95 (us)" << std::setw(12) << "Stddev %" << std::setw(10) << "Speedup" << "\n";
+    for (const BenchRecord& r : records) {
+        out << std::left << std::setw(12) << r.algorithm << std::setw(10) << r.variant
+            << std::right << std::setw(10) << r.size << std::setw(8) << r.threads;
+        if (!r.ok) {
+            out << "  FAILED: " << r.error << "\n";
+            continue;
+        }
+        double rel = r.stats.mean > 0.0 ? 100.0 * r.stats.stddev / r.stats.mean : 0.0;
+        out << std::fixed << std::setprecision(1)
+            << std::setw(14) << r.stats.median << std::setw(14) << r.stats.min
+            << std::setw(14) << r.stats.p95 << std::setw(12) << rel
+            << std::setprecision(2) << std::setw(10) << r.speedup << "\n";
+        out.unsetf(std::ios::fixed);
+    }
+}
+
+// Function to parse a comma-separated list of integers such as "2,4,8"
+inline std::vector<long> parseLongList(const std::string& list) {
+    std::vector<long> values;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(std::stol(item));
+    }
+    return values;
+}
+
+// Function to split a comma-separated list of names
+inline std::vector<std::string> parseNameList(const std::string& list) {
+    std::vector<std::string> names;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) names.push_back(item);
+    }
+    return names;
+}
+
+#endif // BENCH_H
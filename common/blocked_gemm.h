@@ -0,0 +1,68 @@
+#ifndef BLOCKED_GEMM_H
+#define BLOCKED_GEMM_H
+
+// Cache-blocked dense GEMM on row-major buffers:
+//
+//   blockedGemm(m, n, k, A, lda, B, ldb, C, ldc, threads);   // C += A * B
+//
+// A is m x k, B is k x n and C is m x n; the leading dimensions are the row
+// strides, so the operands can be sub-blocks of larger matrices. C is split
+// into GEMM_BLOCK_M x GEMM_BLOCK_N tiles that are shared out over an OpenMP
+// team of the given size (without -fopenmp the pragmas are ignored and the
+// multiply runs serially). Each tile walks k in GEMM_BLOCK_K steps so the
+// slice of B it streams stays in cache, and the inner i-k-j loop runs along
+// contiguous rows of B and C, which the compiler vectorizes.
+
+#include <algorithm>
+
+#ifndef GEMM_BLOCK_M
+#define GEMM_BLOCK_M 64
+#endif
+#ifndef GEMM_BLOCK_N
+#define GEMM_BLOCK_N 256
+#endif
+#ifndef GEMM_BLOCK_K
+#define GEMM_BLOCK_K 256
+#endif
+
+// Function to accumulate one tile: C[i0:i1, j0:j1] += A[i0:i1, :] * B[:, j0:j1]
+template <class T>
+inline void gemmTile(long i0, long i1, long j0, long j1, long k,
+                     const T* A, long lda, const T* B, long ldb, T* C, long ldc)
+{
+    for (long k0 = 0; k0 < k; k0 += GEMM_BLOCK_K) {
+        const long k1 = std::min(k, k0 + GEMM_BLOCK_K);
+        for (long i = i0; i < i1; i++) {
+            T* c = C + i * ldc;
+            const T* a = A + i * lda;
+            for (long kk = k0; kk < k1; kk++) {
+                const T aik = a[kk];
+                const T* b = B + kk * ldb;
+                for (long j = j0; j < j1; j++) {
+                    c[j] += aik * b[j];
+                }
+            }
+        }
+    }
+}
+
+// Function to compute C += A * B with the given number of threads
+template <class T>
+void blockedGemm(long m, long n, long k, const T* A, long lda, const T* B, long ldb,
+                 T* C, long ldc, int threads)
+{
+    const long tiles_m = (m + GEMM_BLOCK_M - 1) / GEMM_BLOCK_M;
+    const long tiles_n = (n + GEMM_BLOCK_N - 1) / GEMM_BLOCK_N;
+
+    #pragma omp parallel for collapse(2) schedule(static) num_threads(threads) if(threads > 1)
+    for (long ti = 0; ti < tiles_m; ti++) {
+        for (long tj = 0; tj < tiles_n; tj++) {
+            const long i0 = ti * GEMM_BLOCK_M;
+            const long j0 = tj * GEMM_BLOCK_N;
+            gemmTile(i0, std::min(m, i0 + GEMM_BLOCK_M), j0, std::min(n, j0 + GEMM_BLOCK_N), k,
+                     A, lda, B, ldb, C, ldc);
+        }
+    }
+}
+
+#endif // BLOCKED_GEMM_H
@@ -0,0 +1,211 @@
+#ifndef FAST_IO_H
+#define FAST_IO_H
+
+// Parallel writer for large integer result arrays (e.g. K-means cluster IDs).
+//
+//   PositionedFile file;
+//   if (!file.open(path, error)) { ... }
+//   file.writeAt(header.data(), header.size(), 0);
+//   writeIdsText(file, header.size(), ids, n, threads);   // "3 0 7 ... 2\n"
+//
+// The IDs are cut into rounds of FAST_IO_CHUNK values per thread. Within a
+// round every thread formats its chunk into its own buffer, the buffer
+// offsets are found with a prefix sum over their lengths, and every thread
+// writes its buffer with pwrite() at its offset. Formatting and writing both
+// scale with the thread count, and memory stays bounded by one round.
+// writeIdsBinary() writes the same IDs as raw uint16_t or uint32_t values.
+// The loops are OpenMP pragmas, guarded by _OPENMP so that programs built
+// without -fopenmp (the input generators) compile them serially and quietly.
+//
+// writeRecords() is for output made of fixed-size records (the input
+// generators): every record's offset is known up front, so the file is
+// presized and std::threads write chunks in whatever order they finish.
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef FAST_IO_CHUNK
+#define FAST_IO_CHUNK (1L << 20)
+#endif
+
+// Output file written at explicit offsets
+class PositionedFile {
+public:
+    PositionedFile() : fd_(-1) {}
+    ~PositionedFile() { close(); }
+
+    PositionedFile(const PositionedFile&) = delete;
+    PositionedFile& operator=(const PositionedFile&) = delete;
+
+    // Function to create (or truncate) the file. Returns false and fills in
+    // error on failure.
+    bool open(const std::string& path, std::string& error) {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            error = "Unable to open " + path + ": " + strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    // Function to write size bytes at offset; safe to call from several
+    // threads at once for disjoint ranges
+    bool writeAt(const void* data, size_t size, off_t offset) const {
+        const char* p = (const char*)data;
+        while (size > 0) {
+            ssize_t written = pwrite(fd_, p, size, offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += written;
+            size -= (size_t)written;
+            offset += written;
+        }
+        return true;
+    }
+
+    // Function to set the file size, e.g. to presize it before the writes
+    bool resize(off_t size) const { return ftruncate(fd_, size) == 0; }
+
+    bool close() {
+        if (fd_ < 0) return true;
+        int result = ::close(fd_);
+        fd_ = -1;
+        return result == 0;
+    }
+
+private:
+    int fd_;
+};
+
+// Function to format value in decimal at out; returns the end of the text
+inline char* formatUnsigned(char* out, uint32_t value) {
+    static const char digits[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char buffer[10];
+    char* p = buffer + sizeof(buffer);
+    while (value >= 100) {
+        const uint32_t pair = (value % 100) * 2;
+        value /= 100;
+        *--p = digits[pair + 1];
+        *--p = digits[pair];
+    }
+    if (value >= 10) {
+        *--p = digits[value * 2 + 1];
+        *--p = digits[value * 2];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    const size_t length = (size_t)(buffer + sizeof(buffer) - p);
+    memcpy(out, p, length);
+    return out + length;
+}
+
+// Function to write [0, n) in chunks from offset: format(begin, end, buffer)
+// fills buffer with the bytes of values [begin, end). Returns the offset
+// after the last byte, or -1 if a write fails.
+template <class Format>
+off_t writeChunks(const PositionedFile& file, off_t offset, long n, int threads, Format format) {
+    threads = std::max(threads, 1);
+    std::vector<std::vector<char> > buffers(threads);
+    std::vector<off_t> offsets(threads + 1);
+    bool failed = false;
+
+    for (long base = 0; base < n; base += (long)threads * FAST_IO_CHUNK) {
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static, 1) num_threads(threads) if(threads > 1)
+#endif
+        for (int t = 0; t < threads; t++) {
+            const long begin = std::min(n, base + t * FAST_IO_CHUNK);
+            const long end = std::min(n, begin + FAST_IO_CHUNK);
+            format(begin, end, buffers[t]);
+        }
+
+        offsets[0] = offset;
+        for (int t = 0; t < threads; t++) offsets[t + 1] = offsets[t] + (off_t)buffers[t].size();
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static, 1) num_threads(threads) if(threads > 1) reduction(||:failed)
+#endif
+        for (int t = 0; t < threads; t++) {
+            if (!file.writeAt(buffers[t].data(), buffers[t].size(), offsets[t])) failed = true;
+        }
+        if (failed) return -1;
+        offset = offsets[threads];
+    }
+    return offset;
+}
+
+// Function to write ids[0, n) as space-separated decimal text ending in a
+// newline, starting at offset. Returns the offset after the text, or -1 if
+// a write fails.
+template <class T>
+off_t writeIdsText(const PositionedFile& file, off_t offset, const T* ids, long n, int threads) {
+    return writeChunks(file, offset, n, threads, [&](long begin, long end, std::vector<char>& buffer) {
+        // Up to 10 digits and a separator per value
+        buffer.resize((size_t)(end - begin) * 11);
+        char* p = buffer.data();
+        for (long i = begin; i < end; i++) {
+            p = formatUnsigned(p, (uint32_t)ids[i]);
+            *p++ = (i < n - 1) ? ' ' : '\n';
+        }
+        buffer.resize((size_t)(p - buffer.data()));
+    });
+}
+
+// Function to write ids[0, n) as raw values of type Out in host byte order,
+// starting at offset. Returns the offset after the data, or -1 if a write
+// fails.
+template <class Out, class T>
+off_t writeIdsBinary(const PositionedFile& file, off_t offset, const T* ids, long n, int threads) {
+    return writeChunks(file, offset, n, threads, [&](long begin, long end, std::vector<char>& buffer) {
+        buffer.resize((size_t)(end - begin) * sizeof(Out));
+        Out* out = (Out*)buffer.data();
+        for (long i = begin; i < end; i++) out[i - begin] = (Out)ids[i];
+    });
+}
+
+// Function to write count records of record_bytes bytes each from offset.
+// Threads take chunks of chunk_records records; format(begin, end, out) fills
+// out with records [begin, end). Uses std::thread so that it runs in
+// parallel in programs built without OpenMP. Returns false if a write fails.
+template <class Format>
+bool writeRecords(const PositionedFile& file, off_t offset, long count, size_t record_bytes,
+                  long chunk_records, int threads, Format format) {
+    std::atomic<long> next(0);
+    std::atomic<bool> failed(false);
+    auto worker = [&]() {
+        std::vector<char> buffer((size_t)chunk_records * record_bytes);
+        for (;;) {
+            const long begin = next.fetch_add(chunk_records);
+            if (begin >= count || failed.load()) break;
+            const long end = std::min(count, begin + chunk_records);
+            format(begin, end, buffer.data());
+            if (!file.writeAt(buffer.data(), (size_t)(end - begin) * record_bytes,
+                              offset + (off_t)begin * (off_t)record_bytes)) {
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(worker);
+    worker();
+    for (std::thread& thread : workers) thread.join();
+    return !failed.load();
+}
+
+#endif // FAST_IO_H
@@ -0,0 +1,198 @@
+#ifndef NUMA_UTIL_H
+#define NUMA_UTIL_H
+
+// Helpers for NUMA-aware runs of the OpenMP kernels:
+//  - thread pinning (compact fills one node before the next, scatter
+//    round-robins threads across nodes),
+//  - reporting which node the pages of a buffer live on.
+// First-touch placement itself is done by the kernels: they touch their
+// buffers in a parallel loop with the same static schedule as the compute
+// loop, after the threads have been pinned.
+//
+// Only Linux is supported; elsewhere pinning and reporting are no-ops.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+enum class PinMode { None, Compact, Scatter };
+
+// Function to parse "compact" / "scatter" / "none"
+inline bool parsePinMode(const std::string& value, PinMode& mode) {
+    if (value == "compact") mode = PinMode::Compact;
+    else if (value == "scatter") mode = PinMode::Scatter;
+    else if (value == "none") mode = PinMode::None;
+    else return false;
+    return true;
+}
+
+// Function to parse a Linux cpulist string such as "0-3,8,10-11"
+inline std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = (dash == std::string::npos) ? first : std::atoi(range.c_str() + dash + 1);
+        for (int c = first; c <= last; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+// Function to list the CPUs of each NUMA node that this process may run on.
+// Falls back to a single node holding every allowed CPU.
+inline std::vector<std::vector<int>> numaNodeCpus() {
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    for (int node = 0; ; ++node) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in.is_open()) break;
+        std::string list;
+        std::getline(in, list);
+
+        std::vector<int> cpus;
+        for (int c : parseCpuList(list)) {
+            if (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+
+    if (nodes.empty()) {
+        std::vector<int> cpus;
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+        nodes.push_back(cpus);
+    }
+#endif
+    return nodes;
+}
+
+// Function to pick the CPU for each of num_threads threads
+inline std::vector<int> pinningOrder(PinMode mode, int num_threads) {
+    std::vector<std::vector<int>> nodes = numaNodeCpus();
+    std::vector<int> order;
+    if (mode == PinMode::None || nodes.empty()) return order;
+
+    std::vector<int> cpus;
+    if (mode == PinMode::Compact) {
+        for (const auto& node : nodes) cpus.insert(cpus.end(), node.begin(), node.end());
+    } else {
+        size_t longest = 0;
+        for (const auto& node : nodes) longest = std::max(longest, node.size());
+        for (size_t i = 0; i < longest; ++i) {
+            for (const auto& node : nodes) {
+                if (i < node.size()) cpus.push_back(node[i]);
+            }
+        }
+    }
+
+    // Oversubscribed runs wrap around the CPU list
+    for (int t = 0; t < num_threads; ++t) order.push_back(cpus[t % cpus.size()]);
+    return order;
+}
+
+// Function to pin the threads of an OpenMP team of num_threads threads.
+// libgomp reuses the same threads for later teams of the same size, so the
+// pinning sticks for the rest of the run.
+inline void pinThreads(PinMode mode, int num_threads) {
+#ifdef __linux__
+    std::vector<int> order = pinningOrder(mode, num_threads);
+    if (order.empty()) return;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(order[omp_get_thread_num()], &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            #pragma omp critical
+            std::cerr << "Warning: Unable to pin thread " << omp_get_thread_num()
+                      << " to CPU " << order[omp_get_thread_num()] << std::endl;
+        }
+    }
+#else
+    (void)mode;
+    (void)num_threads;
+#endif
+}
+
+// Accumulates the node of every page of one or more memory ranges
+class NumaPlacement {
+public:
+    // Function to add the pages of [ptr, ptr + bytes) to the report
+    void addRange(const void* ptr, size_t bytes) {
+#ifdef __linux__
+        const long page = sysconf(_SC_PAGESIZE);
+        uintptr_t first = reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(page - 1);
+        uintptr_t last = reinterpret_cast<uintptr_t>(ptr) + bytes;
+
+        const size_t batch = 4096;
+        std::vector<void*> pages;
+        std::vector<int> status;
+        pages.reserve(batch);
+        for (uintptr_t addr = first; addr < last; ) {
+            pages.clear();
+            for (; addr < last && pages.size() < batch; addr += page) {
+                pages.push_back(reinterpret_cast<void*>(addr));
+            }
+            status.assign(pages.size(), -1);
+
+            // move_pages with no target nodes only queries the current node
+            if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+                unknown_ += pages.size();
+                continue;
+            }
+            for (int node : status) {
+                if (node < 0) {
+                    unknown_++;
+                } else {
+                    if ((size_t)node >= pages_per_node_.size()) pages_per_node_.resize(node + 1, 0);
+                    pages_per_node_[node]++;
+                }
+            }
+        }
+#else
+        (void)ptr;
+        (void)bytes;
+#endif
+    }
+
+    // Function to print the per-node page counts to stderr
+    void print(const std::string& name) const {
+        size_t total = unknown_;
+        for (size_t n : pages_per_node_) total += n;
+        std::cerr << "NUMA placement of " << name << " (" << total << " pages):";
+        for (size_t node = 0; node < pages_per_node_.size(); ++node) {
+            std::cerr << " node" << node << "=" << pages_per_node_[node]
+                      << " (" << (total ? 100.0 * pages_per_node_[node] / total : 0.0) << "%)";
+        }
+        if (unknown_) std::cerr << " unmapped=" << unknown_;
+        std::cerr << std::endl;
+    }
+
+private:
+    std::vector<size_t> pages_per_node_;
+    size_t unknown_ = 0;
+};
+
+#endif // NUMA_UTIL_H
@@ -0,0 +1,283 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Per-thread, per-phase hardware counters read through Linux perf_event_open.
+//
+// Set PERF_COUNTERS=1 in the environment to enable. Each thread that enters a
+// PerfScope opens its own counter group (cycles, instructions, cache misses,
+// LLC read misses, branch misses) on first use; the scope reads the group on
+// entry and exit and adds the difference to that thread's totals for the
+// phase. perfReport() prints the totals per phase and per thread, so a
+// regression can be attributed to compute (IPC), memory (cache / LLC misses)
+// or synchronization (cycles without matching instructions).
+//
+// When disabled a scope costs one predictable branch. Counting is user space
+// only, so the default perf_event_paranoid setting of 2 is enough. Events the
+// CPU or hypervisor does not expose are reported as n/a.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#ifdef USE_WS_POOL
+#include "ws_pool.h"
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define PERF_NUM_EVENTS 5
+
+// Names of the counted events, in group order
+static const char* const kPerfEventNames[PERF_NUM_EVENTS] = {
+    "cycles", "instructions", "cache-misses", "LLC-misses", "branch-misses"};
+
+// Counter totals of one phase on one thread
+struct PerfPhaseTotals {
+    uint64_t calls = 0;
+    double values[PERF_NUM_EVENTS] = {0, 0, 0, 0, 0};
+};
+
+// Counter group and totals owned by one thread
+struct PerfThreadState {
+    int thread = 0;   // OpenMP thread number, or pool worker index in USE_WS_POOL builds
+    int fds[PERF_NUM_EVENTS] = {-1, -1, -1, -1, -1};
+    int slot[PERF_NUM_EVENTS] = {-1, -1, -1, -1, -1};   // Position in the group read, -1 if not open
+    int opened = 0;
+    std::vector<PerfPhaseTotals> phases;
+};
+
+// Global registry of phases and thread states
+struct PerfRegistry {
+    bool enabled = false;
+    std::string open_error;
+    std::vector<std::string> phase_names;
+    std::vector<PerfThreadState*> threads;
+    std::mutex lock;
+
+    PerfRegistry() {
+        const char* env = std::getenv("PERF_COUNTERS");
+        enabled = env != nullptr && std::strcmp(env, "0") != 0 && env[0] != '\0';
+    }
+
+    ~PerfRegistry() {
+        for (PerfThreadState* state : threads) {
+#ifdef __linux__
+            for (int e = 0; e < PERF_NUM_EVENTS; ++e) {
+                if (state->fds[e] >= 0) close(state->fds[e]);
+            }
+#endif
+            delete state;
+        }
+    }
+};
+
+inline PerfRegistry& perfRegistry() {
+    static PerfRegistry registry;
+    return registry;
+}
+
+// Function to check whether PERF_COUNTERS is set
+inline bool perfCountersEnabled() {
+    return perfRegistry().enabled;
+}
+
+// Function to register a phase name and get its id. Call before the
+// parallel regions that use it.
+inline int perfRegisterPhase(const std::string& name) {
+    PerfRegistry& registry = perfRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (size_t i = 0; i < registry.phase_names.size(); ++i) {
+        if (registry.phase_names[i] == name) return static_cast<int>(i);
+    }
+    registry.phase_names.push_back(name);
+    return static_cast<int>(registry.phase_names.size() - 1);
+}
+
+#ifdef __linux__
+// Function to open one counter, joining the group of leader_fd if >= 0
+inline int perfOpenEvent(uint32_t type, uint64_t config, int leader_fd) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = leader_fd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_fd, 0));
+}
+#endif
+
+// Function to number the calling thread in the report. Pool workers run on
+// plain std::threads, where omp_get_thread_num() is always 0, so pool
+// builds use the worker index.
+inline int perfThreadNumber() {
+#ifdef USE_WS_POOL
+    if (WorkStealingPool::currentWorker() >= 0) return WorkStealingPool::currentWorker();
+#endif
+    return omp_get_thread_num();
+}
+
+// Function to get the calling thread's state, opening its counters on
+// first use
+inline PerfThreadState* perfThreadState() {
+    static thread_local PerfThreadState* state = nullptr;
+    if (state != nullptr) return state;
+
+    PerfRegistry& registry = perfRegistry();
+    state = new PerfThreadState();
+    state->thread = perfThreadNumber();
+
+#ifdef __linux__
+    const uint64_t llc_read_miss = PERF_COUNT_HW_CACHE_LL |
+                                   (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const uint32_t types[PERF_NUM_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                             PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    const uint64_t configs[PERF_NUM_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                               PERF_COUNT_HW_CACHE_MISSES, llc_read_miss,
+                                               PERF_COUNT_HW_BRANCH_MISSES};
+
+    int leader = -1;
+    for (int e = 0; e < PERF_NUM_EVENTS; ++e) {
+        int fd = perfOpenEvent(types[e], configs[e], leader);
+        if (fd < 0) {
+            if (e == 0) {
+                std::lock_guard<std::mutex> guard(registry.lock);
+                if (registry.open_error.empty()) registry.open_error = std::strerror(errno);
+                break;
+            }
+            continue;
+        }
+        if (leader < 0) leader = fd;
+        state->fds[e] = fd;
+        state->slot[e] = state->opened++;
+    }
+    if (leader >= 0) {
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+
+    std::lock_guard<std::mutex> guard(registry.lock);
+    state->phases.resize(registry.phase_names.size());
+    registry.threads.push_back(state);
+    return state;
+}
+
+// Function to read the thread's counter group into values, scaled for
+// multiplexing. Returns false if no counters are open.
+inline bool perfReadGroup(const PerfThreadState* state, double values[PERF_NUM_EVENTS]) {
+#ifdef __linux__
+    if (state->opened == 0) return false;
+    uint64_t buffer[3 + PERF_NUM_EVENTS];
+    if (read(state->fds[0], buffer, sizeof(buffer)) <= 0) return false;
+
+    // Layout: nr, time_enabled, time_running, value[nr]
+    double scale = (buffer[2] > 0) ? static_cast<double>(buffer[1]) / buffer[2] : 1.0;
+    for (int e = 0; e < PERF_NUM_EVENTS; ++e) {
+        values[e] = state->slot[e] >= 0 ? buffer[3 + state->slot[e]] * scale : 0.0;
+    }
+    return true;
+#else
+    (void)state;
+    (void)values;
+    return false;
+#endif
+}
+
+// Counts the enclosing block as one call of a phase on the calling thread
+class PerfScope {
+public:
+    explicit PerfScope(int phase) : phase_(phase), state_(nullptr), start_() {
+        if (!perfCountersEnabled()) return;
+        state_ = perfThreadState();
+        if (!perfReadGroup(state_, start_)) state_ = nullptr;
+    }
+
+    ~PerfScope() {
+        if (state_ == nullptr) return;
+        double end[PERF_NUM_EVENTS];
+        if (!perfReadGroup(state_, end)) return;
+        if (static_cast<size_t>(phase_) >= state_->phases.size()) state_->phases.resize(phase_ + 1);
+        PerfPhaseTotals& totals = state_->phases[phase_];
+        totals.calls++;
+        for (int e = 0; e < PERF_NUM_EVENTS; ++e) totals.values[e] += end[e] - start_[e];
+    }
+
+private:
+    int phase_;
+    PerfThreadState* state_;
+    double start_[PERF_NUM_EVENTS];
+};
+
+// Function to discard the counter totals so far, e.g. those of warm-up or
+// tuning runs. Call outside parallel regions.
+inline void perfReset() {
+    PerfRegistry& registry = perfRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (PerfThreadState* state : registry.threads) state->phases.clear();
+}
+
+// Function to print the counter totals of every phase, per thread and summed
+inline void perfReport(std::ostream& out) {
+    PerfRegistry& registry = perfRegistry();
+    if (!registry.enabled) return;
+
+    std::lock_guard<std::mutex> guard(registry.lock);
+    bool available[PERF_NUM_EVENTS] = {false, false, false, false, false};
+    for (const PerfThreadState* state : registry.threads) {
+        for (int e = 0; e < PERF_NUM_EVENTS; ++e) available[e] = available[e] || state->slot[e] >= 0;
+    }
+
+    // ENOENT means no PMU is exposed (common in VMs); EACCES means
+    // perf_event_paranoid is too strict
+    if (!registry.open_error.empty()) {
+        out << "Hardware counters unavailable on some threads: " << registry.open_error << std::endl;
+    }
+    if (!available[0]) return;
+
+    auto print_row = [&](const std::string& label, const PerfPhaseTotals& t) {
+        out << "  " << std::left << std::setw(10) << label << std::right << std::setw(10) << t.calls;
+        for (int e = 0; e < PERF_NUM_EVENTS; ++e) {
+            if (available[e]) out << std::setw(16) << static_cast<uint64_t>(t.values[e]);
+            else out << std::setw(16) << "n/a";
+        }
+        double ipc = t.values[0] > 0 ? t.values[1] / t.values[0] : 0.0;
+        out << std::fixed << std::setprecision(2) << std::setw(8) << ipc << std::endl;
+        out.unsetf(std::ios::fixed);
+    };
+
+    out << "\nHardware counters per phase (user space):" << std::endl;
+    for (size_t p = 0; p < registry.phase_names.size(); ++p) {
+        out << registry.phase_names[p] << ":" << std::endl;
+        out << "  " << std::left << std::setw(10) << "thread" << std::right << std::setw(10) << "calls";
+        for (int e = 0; e < PERF_NUM_EVENTS; ++e) out << std::setw(16) << kPerfEventNames[e];
+        out << std::setw(8) << "IPC" << std::endl;
+
+        PerfPhaseTotals sum;
+        for (const PerfThreadState* state : registry.threads) {
+            if (p >= state->phases.size() || state->phases[p].calls == 0) continue;
+            const PerfPhaseTotals& t = state->phases[p];
+            print_row(std::to_string(state->thread), t);
+            sum.calls += t.calls;
+            for (int e = 0; e < PERF_NUM_EVENTS; ++e) sum.values[e] += t.values[e];
+        }
+        print_row("total", sum);
+    }
+}
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,136 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+// Philox4x32-10 counter-based random number generator (Salmon et al.,
+// "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11).
+//
+// Output is a pure function of a 128-bit counter and a 64-bit key, so any
+// thread can generate any part of a stream without shared state, and streams
+// that differ in the counter or the key never overlap. The batch function
+// keeps the lanes in separate arrays so the compiler can run the rounds at
+// full SIMD width.
+
+#include <cstdint>
+
+struct PhiloxKey {
+    uint32_t k0;
+    uint32_t k1;
+};
+
+// Function to build a key from a 64-bit seed
+inline PhiloxKey philoxKeyFromSeed(uint64_t seed) {
+    return PhiloxKey{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+}
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// Function to compute one Philox4x32-10 block for a single counter
+inline void philox4x32(const uint32_t ctr[4], PhiloxKey key, uint32_t out[4]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key.k0, k1 = key.k1;
+    for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+        uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+        uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c0 = n0;
+        c1 = static_cast<uint32_t>(p1);
+        c2 = n2;
+        c3 = static_cast<uint32_t>(p0);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// Function to compute Lanes consecutive Philox4x32-10 blocks. Lane l uses the
+// counter {first + l (64-bit), c2, c3}; word w of its output goes to out[w][l].
+// The lane loop is the outer one so that it is what the compiler vectorizes;
+// the rounds are unrolled inside it.
+template <int Lanes>
+inline void philox4x32Batch(uint64_t first, uint32_t c2, uint32_t c3, PhiloxKey key, uint32_t out[4][Lanes]) {
+    uint32_t k0[PHILOX_ROUNDS], k1[PHILOX_ROUNDS];
+    k0[0] = key.k0;
+    k1[0] = key.k1;
+    for (int r = 1; r < PHILOX_ROUNDS; ++r) {
+        k0[r] = k0[r - 1] + PHILOX_W0;
+        k1[r] = k1[r - 1] + PHILOX_W1;
+    }
+
+    for (int l = 0; l < Lanes; ++l) {
+        uint64_t ctr = first + static_cast<uint64_t>(l);
+        uint32_t x0 = static_cast<uint32_t>(ctr);
+        uint32_t x1 = static_cast<uint32_t>(ctr >> 32);
+        uint32_t x2 = c2;
+        uint32_t x3 = c3;
+
+        #pragma GCC unroll 10
+        for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * x0;
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * x2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ x1 ^ k0[r];
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ x3 ^ k1[r];
+            x0 = n0;
+            x1 = static_cast<uint32_t>(p1);
+            x2 = n2;
+            x3 = static_cast<uint32_t>(p0);
+        }
+
+        out[0][l] = x0;
+        out[1][l] = x1;
+        out[2][l] = x2;
+        out[3][l] = x3;
+    }
+}
+
+// Sequential reader of one stream: value i of stream s under a key is word
+// i % 4 of the block with counter {i / 4 (64-bit), s, 0}. A reader can start
+// at any position, so chunks of a stream can be generated independently and
+// the result does not depend on how the stream is split.
+class PhiloxStream {
+public:
+    PhiloxStream(PhiloxKey key, uint32_t stream, uint64_t position)
+        : key_(key), stream_(stream), block_(position / 4), index_(static_cast<int>(position % 4)) {
+        refill();
+    }
+
+    uint32_t next() {
+        if (index_ == 4) {
+            ++block_;
+            index_ = 0;
+            refill();
+        }
+        return words_[index_++];
+    }
+
+private:
+    void refill() {
+        const uint32_t ctr[4] = {static_cast<uint32_t>(block_), static_cast<uint32_t>(block_ >> 32), stream_, 0};
+        philox4x32(ctr, key_, words_);
+    }
+
+    PhiloxKey key_;
+    uint32_t stream_;
+    uint64_t block_;
+    int index_;
+    uint32_t words_[4];
+};
+
+// Function to map 32 random bits to a float in (0, 1) using the top 24 bits
+inline float uint32ToUnitFloat(uint32_t bits) {
+    return (static_cast<float>(bits >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+// Function to map 64 random bits to a double in (0, 1) using the top 53 bits
+inline double uint64ToUnitDouble(uint64_t bits) {
+    return (static_cast<double>(bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+#endif // PHILOX_H
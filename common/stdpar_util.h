@@ -0,0 +1,92 @@
+#ifndef STDPAR_UTIL_H
+#define STDPAR_UTIL_H
+
+// Helpers for the C++17 parallel algorithm (std::execution) versions of the
+// kernels.
+//
+// libstdc++ runs std::execution::par / par_unseq on TBB when the program is
+// linked with -ltbb; without TBB the algorithms fall back to sequential
+// execution. The standard gives no way to set the thread count, so
+// ParallelismLimit uses tbb::global_control when TBB is available.
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+#if defined(__has_include)
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define STDPAR_HAVE_TBB 1
+#endif
+#endif
+
+// Random-access iterator over the integers [begin, end), so that index loops
+// can be written as std::for_each / std::transform_reduce without building
+// an index array
+class CountingIterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef long value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const long* pointer;
+    typedef long reference;
+
+    CountingIterator() : value_(0) {}
+    explicit CountingIterator(long value) : value_(value) {}
+
+    long operator*() const { return value_; }
+    long operator[](difference_type n) const { return value_ + n; }
+
+    CountingIterator& operator++() { ++value_; return *this; }
+    CountingIterator operator++(int) { CountingIterator old = *this; ++value_; return old; }
+    CountingIterator& operator--() { --value_; return *this; }
+    CountingIterator operator--(int) { CountingIterator old = *this; --value_; return old; }
+    CountingIterator& operator+=(difference_type n) { value_ += n; return *this; }
+    CountingIterator& operator-=(difference_type n) { value_ -= n; return *this; }
+
+    friend CountingIterator operator+(CountingIterator it, difference_type n) { return it += n; }
+    friend CountingIterator operator+(difference_type n, CountingIterator it) { return it += n; }
+    friend CountingIterator operator-(CountingIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(CountingIterator a, CountingIterator b) { return a.value_ - b.value_; }
+
+    friend bool operator==(CountingIterator a, CountingIterator b) { return a.value_ == b.value_; }
+    friend bool operator!=(CountingIterator a, CountingIterator b) { return a.value_ != b.value_; }
+    friend bool operator<(CountingIterator a, CountingIterator b) { return a.value_ < b.value_; }
+    friend bool operator>(CountingIterator a, CountingIterator b) { return a.value_ > b.value_; }
+    friend bool operator<=(CountingIterator a, CountingIterator b) { return a.value_ <= b.value_; }
+    friend bool operator>=(CountingIterator a, CountingIterator b) { return a.value_ >= b.value_; }
+
+private:
+    long value_;
+};
+
+// Caps the number of threads the parallel algorithms use while it is alive.
+// threads <= 0 leaves the backend's default (all cores).
+class ParallelismLimit {
+public:
+    explicit ParallelismLimit(int threads) {
+#ifdef STDPAR_HAVE_TBB
+        if (threads > 0) {
+            control_.reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, threads));
+        }
+#else
+        (void)threads;
+#endif
+    }
+
+    // Function to check whether the thread count can actually be applied
+    static bool supported() {
+#ifdef STDPAR_HAVE_TBB
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+#ifdef STDPAR_HAVE_TBB
+    std::unique_ptr<tbb::global_control> control_;
+#endif
+};
+
+#endif // STDPAR_UTIL_H
@@ -0,0 +1,322 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Low-overhead per-phase tracing with Chrome trace / Perfetto JSON export.
+//
+// Each thread records complete events (name, begin, end) into its own ring
+// buffer using the CPU timestamp counter, so recording takes no lock, makes
+// no system call and never shares a cache line with another thread. When the
+// buffer is full the oldest events are overwritten and counted as dropped.
+// Each thread also keeps running per-phase totals next to its ring, so the
+// summary counts every event even after the ring has wrapped.
+// After the run the buffers are merged, timestamps are converted to
+// microseconds against steady_clock, and the result is written as a JSON file
+// that chrome://tracing and ui.perfetto.dev open directly.
+//
+// The TRACE_* macros compile to nothing unless ENABLE_TRACING is defined, so
+// the kernels can be annotated permanently:
+//
+//   TRACE_SCOPE("kmeans.assign");     // Records the enclosing block
+//   TRACE_WRITE();                    // Writes $TRACE_FILE (default trace.json)
+//
+// Event names must be string literals or otherwise outlive the run; only the
+// pointer is stored.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#ifdef USE_WS_POOL
+#include "ws_pool.h"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Default number of events kept per thread; TRACE_BUFFER_EVENTS overrides it
+#define TRACE_DEFAULT_EVENTS (1 << 16)
+
+// Function to read a cheap monotonic tick counter
+inline uint64_t traceTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// One complete event
+struct TraceEvent {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Running totals of one phase on one thread, in ticks
+struct TracePhaseTotals {
+    const char* name;
+    uint64_t count;
+    uint64_t ticks;
+    uint64_t max_ticks;
+};
+
+// Events recorded by one thread, padded so that the write positions of two
+// threads never share a cache line
+struct TraceBuffer {
+    int tid = 0;                  // Registration order, used as the trace tid
+    std::string name;             // Thread label, e.g. "omp thread 3" (traceThreadName())
+    uint64_t written = 0;         // Total events recorded, including overwritten ones
+    std::vector<TraceEvent> events;
+    std::vector<TracePhaseTotals> totals;   // One entry per phase name, never overwritten
+    char padding[64];
+
+    // Function to record one event, overwriting the oldest when full, and
+    // add it to its phase's totals
+    void record(const char* name, uint64_t begin, uint64_t end) {
+        TraceEvent& e = events[written % events.size()];
+        e.name = name;
+        e.begin = begin;
+        e.end = end;
+        written++;
+
+        TracePhaseTotals& t = phaseTotals(name);
+        const uint64_t ticks = end - begin;
+        t.count++;
+        t.ticks += ticks;
+        t.max_ticks = std::max(t.max_ticks, ticks);
+    }
+
+    // Function to find a phase's totals by name pointer; a thread records
+    // a handful of phases, so a linear scan is cheapest
+    TracePhaseTotals& phaseTotals(const char* name) {
+        for (TracePhaseTotals& t : totals) {
+            if (t.name == name) return t;
+        }
+        totals.push_back({name, 0, 0, 0});
+        return totals.back();
+    }
+};
+
+// Per-phase totals computed from a merged trace
+struct TracePhaseSummary {
+    uint64_t count = 0;
+    double total_us = 0.0;   // Summed over all threads
+    double max_us = 0.0;     // Longest single event
+    int threads = 0;         // Threads that recorded the phase
+};
+
+// Global registry of thread buffers and the clock calibration anchor
+struct TraceRegistry {
+    std::mutex lock;
+    std::vector<TraceBuffer*> buffers;
+    size_t capacity = TRACE_DEFAULT_EVENTS;
+    uint64_t anchor_ticks;
+    std::chrono::steady_clock::time_point anchor_time;
+
+    TraceRegistry() {
+        const char* env = std::getenv("TRACE_BUFFER_EVENTS");
+        if (env != nullptr && std::atol(env) > 0) capacity = static_cast<size_t>(std::atol(env));
+        anchor_time = std::chrono::steady_clock::now();
+        anchor_ticks = traceTicks();
+    }
+
+    ~TraceRegistry() {
+        for (TraceBuffer* buffer : buffers) delete buffer;
+    }
+
+    // Function to get the length of one tick in microseconds, measured
+    // between construction and now
+    double microsPerTick() const {
+        uint64_t ticks = traceTicks();
+        auto now = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(now - anchor_time).count();
+        return ticks > anchor_ticks ? micros / static_cast<double>(ticks - anchor_ticks) : 0.0;
+    }
+};
+
+inline TraceRegistry& traceRegistry() {
+    static TraceRegistry registry;
+    return registry;
+}
+
+// Function to name the calling thread in the trace: its pool worker index in
+// USE_WS_POOL builds (the workers are not OpenMP threads), otherwise its
+// OpenMP thread number
+inline std::string traceThreadName() {
+#ifdef USE_WS_POOL
+    if (WorkStealingPool::currentWorker() >= 0) return "pool worker " + std::to_string(WorkStealingPool::currentWorker());
+#endif
+    return "omp thread " + std::to_string(omp_get_thread_num());
+}
+
+// Function to get the calling thread's buffer, creating it on first use
+inline TraceBuffer* traceThreadBuffer() {
+    static thread_local TraceBuffer* buffer = nullptr;
+    if (buffer != nullptr) return buffer;
+
+    TraceRegistry& registry = traceRegistry();
+    buffer = new TraceBuffer();
+    buffer->name = traceThreadName();
+    buffer->events.resize(registry.capacity);
+    buffer->totals.reserve(16);
+
+    std::lock_guard<std::mutex> guard(registry.lock);
+    buffer->tid = static_cast<int>(registry.buffers.size());
+    registry.buffers.push_back(buffer);
+    return buffer;
+}
+
+// Records the enclosing block as one event on the calling thread
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name_(name), buffer_(traceThreadBuffer()), begin_(traceTicks()) {}
+    ~TraceScope() { buffer_->record(name_, begin_, traceTicks()); }
+
+private:
+    const char* name_;
+    TraceBuffer* buffer_;
+    uint64_t begin_;
+};
+
+// Function to visit every retained event of every thread. Call after all
+// parallel regions have finished.
+template <class Visitor>
+void traceForEach(Visitor visit) {
+    TraceRegistry& registry = traceRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (const TraceBuffer* buffer : registry.buffers) {
+        size_t kept = static_cast<size_t>(std::min<uint64_t>(buffer->written, buffer->events.size()));
+        uint64_t first = buffer->written - kept;
+        for (uint64_t i = first; i < buffer->written; ++i) {
+            visit(*buffer, buffer->events[i % buffer->events.size()]);
+        }
+    }
+}
+
+// Function to sum every recorded event per phase name, including events
+// the rings have since overwritten. Call after all parallel regions have
+// finished.
+inline std::map<std::string, TracePhaseSummary> traceSummary() {
+    TraceRegistry& registry = traceRegistry();
+    const double us_per_tick = registry.microsPerTick();
+    std::map<std::string, TracePhaseSummary> summary;
+
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (const TraceBuffer* buffer : registry.buffers) {
+        // Equal names recorded through different pointers count once per thread
+        std::map<std::string, bool> seen;
+        for (const TracePhaseTotals& t : buffer->totals) {
+            if (t.count == 0) continue;
+            TracePhaseSummary& s = summary[t.name];
+            s.count += t.count;
+            s.total_us += t.ticks * us_per_tick;
+            s.max_us = std::max(s.max_us, t.max_ticks * us_per_tick);
+            if (!seen[t.name]) {
+                seen[t.name] = true;
+                s.threads++;
+            }
+        }
+    }
+    return summary;
+}
+
+// Function to count events lost to ring buffer wrap-around
+inline uint64_t traceDropped() {
+    TraceRegistry& registry = traceRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    uint64_t dropped = 0;
+    for (const TraceBuffer* buffer : registry.buffers) {
+        if (buffer->written > buffer->events.size()) dropped += buffer->written - buffer->events.size();
+    }
+    return dropped;
+}
+
+// Function to discard every recorded event, e.g. those of warm-up or tuning
+// runs. Call outside parallel regions.
+inline void traceReset() {
+    TraceRegistry& registry = traceRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (TraceBuffer* buffer : registry.buffers) {
+        buffer->written = 0;
+        buffer->totals.clear();
+    }
+}
+
+// Function to write all retained events, merged in time order, as Chrome
+// trace JSON. Returns false if the file cannot be written.
+inline bool traceWriteJson(const std::string& filename) {
+    TraceRegistry& registry = traceRegistry();
+    const double us_per_tick = registry.microsPerTick();
+
+    struct Row {
+        int tid;
+        TraceEvent event;
+    };
+    std::vector<Row> rows;
+    traceForEach([&](const TraceBuffer& buffer, const TraceEvent& e) { rows.push_back({buffer.tid, e}); });
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.event.begin < b.event.begin; });
+
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) return false;
+
+    std::fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        for (const TraceBuffer* buffer : registry.buffers) {
+            std::fprintf(file, "%s  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                         "\"args\": {\"name\": \"%s\"}}", first ? "" : ",\n", buffer->tid,
+                         buffer->name.c_str());
+            first = false;
+        }
+    }
+    for (const Row& row : rows) {
+        double ts = (static_cast<int64_t>(row.event.begin - registry.anchor_ticks)) * us_per_tick;
+        double dur = (row.event.end - row.event.begin) * us_per_tick;
+        std::fprintf(file, "%s  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                     "\"ts\": %.3f, \"dur\": %.3f}", first ? "" : ",\n", row.event.name, row.tid, ts, dur);
+        first = false;
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+// Function to write the trace to $TRACE_FILE, or trace.json, and note where
+// it went on stderr
+inline void traceWriteDefault() {
+    const char* env = std::getenv("TRACE_FILE");
+    std::string filename = (env != nullptr && env[0] != '\0') ? env : "trace.json";
+    if (!traceWriteJson(filename)) {
+        std::fprintf(stderr, "Error: Unable to write trace file %s\n", filename.c_str());
+        return;
+    }
+    std::fprintf(stderr, "Trace written to %s", filename.c_str());
+    uint64_t dropped = traceDropped();
+    if (dropped > 0) {
+        std::fprintf(stderr, " (%llu oldest events dropped; raise TRACE_BUFFER_EVENTS)",
+                     static_cast<unsigned long long>(dropped));
+    }
+    std::fprintf(stderr, "\n");
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_WRITE() traceWriteDefault()
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_WRITE() do {} while (0)
+#endif
+
+#endif // TRACE_H
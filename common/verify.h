@@ -0,0 +1,145 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+// Cheap checks of kernel results, run after the timed region by --verify.
+// Each costs about as much as one pass over the inputs instead of a second
+// run of the kernel:
+//
+//   freivaldsCheck()      C = A * B for integer matrices, in O(rounds * n^2)
+//   kmeansConsistency()   centroids are the means of their points and every
+//                         point is assigned to its nearest centroid, in
+//                         O(N * K * D), the cost of one iteration
+//
+// The loops are OpenMP pragmas; without -fopenmp they run serially.
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "philox.h"
+
+// Freivalds rounds are packed as the bits of one 32-bit word per index
+#define FREIVALDS_MAX_ROUNDS 32
+
+// Function to check C = A * B (A is n x k, B is k x m) with Freivalds' test:
+// for random 0/1 vectors r it compares A * (B * r) with C * r. A wrong C
+// passes one round with probability at most 1/2, so all rounds with at most
+// 2^-rounds. The rounds share each pass over the matrices. rowA(i), rowB(i)
+// and rowC(i) return pointers to row i; the sums are exact 64-bit integers.
+// Returns the first row of C that fails, or -1 if C passes.
+template <class RowA, class RowB, class RowC>
+long freivaldsCheck(long n, long k, long m, RowA rowA, RowB rowB, RowC rowC, int rounds, uint64_t seed,
+                    int threads)
+{
+    rounds = std::max(1, std::min(rounds, FREIVALDS_MAX_ROUNDS));
+
+    // Bit t of bits[j] is entry j of vector t
+    std::vector<uint32_t> bits(m);
+    PhiloxStream stream(philoxKeyFromSeed(seed), 0, 0);
+    for (long j = 0; j < m; j++) bits[j] = stream.next();
+
+    // br[i * rounds + t] = (B * r_t)[i]
+    std::vector<int64_t> br((size_t)k * rounds, 0);
+    #pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (long i = 0; i < k; i++) {
+        const auto* row = rowB(i);
+        int64_t* out = &br[(size_t)i * rounds];
+        for (long j = 0; j < m; j++) {
+            const int64_t value = (int64_t)row[j];
+            for (int t = 0; t < rounds; t++) out[t] += value * (int64_t)((bits[j] >> t) & 1);
+        }
+    }
+
+    long first_bad = -1;
+    #pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (long i = 0; i < n; i++) {
+        int64_t abr[FREIVALDS_MAX_ROUNDS] = {0};
+        int64_t cr[FREIVALDS_MAX_ROUNDS] = {0};
+        const auto* a = rowA(i);
+        for (long j = 0; j < k; j++) {
+            const int64_t value = (int64_t)a[j];
+            const int64_t* b = &br[(size_t)j * rounds];
+            for (int t = 0; t < rounds; t++) abr[t] += value * b[t];
+        }
+        const auto* c = rowC(i);
+        for (long j = 0; j < m; j++) {
+            const int64_t value = (int64_t)c[j];
+            for (int t = 0; t < rounds; t++) cr[t] += value * (int64_t)((bits[j] >> t) & 1);
+        }
+        if (!std::equal(abr, abr + rounds, cr)) {
+            #pragma omp critical
+            if (first_bad < 0 || i < first_bad) first_bad = i;
+        }
+    }
+    return first_bad;
+}
+
+// Function to check a converged K-means result: every non-empty centroid
+// must equal the mean of its points, and every point's centroid must be (up
+// to rounding) its nearest. Points and centroids are row-major with D
+// coordinates. Returns false and fills in error on the first violation.
+inline bool kmeansConsistency(const float* points, const int* clusters, long n, int dims,
+                              const float* centroids, int k, int threads, std::string& error)
+{
+    // Recompute the means in double precision
+    std::vector<double> sums((size_t)k * dims, 0.0);
+    std::vector<long> counts(k, 0);
+    for (long i = 0; i < n; i++) {
+        const int c = clusters[i];
+        if (c < 0 || c >= k) {
+            error = "point " + std::to_string(i) + " has no valid cluster";
+            return false;
+        }
+        counts[c]++;
+        for (int d = 0; d < dims; d++) sums[(size_t)c * dims + d] += points[(size_t)i * dims + d];
+    }
+    for (int c = 0; c < k; c++) {
+        if (counts[c] == 0) continue;
+        for (int d = 0; d < dims; d++) {
+            const double mean = sums[(size_t)c * dims + d] / counts[c];
+            const double centroid = centroids[(size_t)c * dims + d];
+            if (std::fabs(mean - centroid) > 1e-4 * std::max(1.0, std::fabs(mean))) {
+                error = "centroid " + std::to_string(c) + " is not the mean of its points";
+                return false;
+            }
+        }
+    }
+
+    // The assigned centroid may only lose to another by rounding error
+    long first_bad = -1;
+    #pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (long i = 0; i < n; i++) {
+        const float* x = points + (size_t)i * dims;
+        double assigned = 0.0, best = HUGE_VAL, scale = 0.0;
+        for (int c = 0; c < k; c++) {
+            const float* y = centroids + (size_t)c * dims;
+            double dist = 0.0, norms = 0.0;
+            for (int d = 0; d < dims; d++) {
+                const double diff = (double)x[d] - (double)y[d];
+                dist += diff * diff;
+                norms += (double)x[d] * x[d] + (double)y[d] * y[d];
+            }
+            if (c == clusters[i]) {
+                assigned = dist;
+                scale = std::max(scale, norms);
+            }
+            if (dist < best) {
+                best = dist;
+                scale = std::max(scale, norms);
+            }
+        }
+        if (assigned - best > 1e-5 * std::max(1.0, scale)) {
+            #pragma omp critical
+            if (first_bad < 0 || i < first_bad) first_bad = i;
+        }
+    }
+    if (first_bad >= 0) {
+        error = "point " + std::to_string(first_bad) + " is not assigned to its nearest centroid";
+        return false;
+    }
+    return true;
+}
+
+#endif // VERIFY_H
@@ -0,0 +1,321 @@
+#ifndef WS_POOL_H
+#define WS_POOL_H
+
+// Persistent work-stealing thread pool, usable in place of OpenMP parallel
+// loops by building a kernel with -DUSE_WS_POOL.
+//
+// The pool starts its threads once. A parallel loop is published as a job and
+// the calling thread joins in as worker 0, so there is no fork or join per
+// loop beyond waking idle workers. Each worker owns a Chase-Lev deque of index
+// ranges: it splits its range in half, pushes the upper half for others to
+// steal and keeps working on the lower half until the range is no larger
+// than the grain (lazy binary splitting, as in Cilk and Rayon). Idle workers
+// steal from random victims, spin for a short while after a job ends so that
+// back-to-back loops (one per Dijkstra iteration, say) do not pay for a wake
+// up, and then park on a condition variable.
+//
+//   WorkStealingPool pool(8);
+//   pool.parallelFor(0, n, 0, [&](long lo, long hi, int worker) { ... });
+//   long sum = pool.parallelReduce(0, n, 0, 0L,
+//       [&](long lo, long hi, int worker) { ...; return partial; },
+//       [](long a, long b) { return a + b; });
+//
+// Bodies receive the index of the worker running them (0 .. size() - 1) so
+// they can accumulate into per-worker buffers without atomics. A loop started
+// from inside a body runs serially on the calling worker.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WS_POOL_PAUSE() _mm_pause()
+#else
+#define WS_POOL_PAUSE() std::this_thread::yield()
+#endif
+
+// Ranges a worker can have queued at once. Splitting halves the range each
+// time, so the depth stays around log2(n / grain).
+#define WS_DEQUE_CAPACITY 256
+
+// Pause iterations an idle worker spins before it parks
+#define WS_IDLE_SPINS 20000
+
+// Failed steal rounds between yields, so that spinning workers give the CPU
+// back when threads outnumber cores
+#define WS_YIELD_EVERY 64
+
+// A parallel loop in flight
+struct WsJob {
+    void (*run)(const void* body, long lo, long hi, int worker);
+    const void* body;
+    long grain;
+    std::atomic<long> remaining;   // Iterations not yet executed
+};
+
+// A range of iterations of one job
+struct WsRange {
+    WsJob* job;
+    long lo;
+    long hi;
+};
+
+// Chase-Lev deque of ranges with a fixed capacity. The owner pushes and pops
+// at the bottom; thieves take from the top. Slot fields are atomics so that
+// a thief's speculative read of a slot is not a data race; the read is only
+// used if the CAS on top succeeds.
+class WsDeque {
+public:
+    WsDeque() : top_(0), bottom_(0) {}
+
+    // Function to push a range (owner only). Returns false when full.
+    bool push(const WsRange& range) {
+        long b = bottom_.load(std::memory_order_relaxed);
+        long t = top_.load(std::memory_order_acquire);
+        if (b - t >= WS_DEQUE_CAPACITY) return false;
+        Slot& slot = slots_[b & (WS_DEQUE_CAPACITY - 1)];
+        slot.job.store(range.job, std::memory_order_relaxed);
+        slot.lo.store(range.lo, std::memory_order_relaxed);
+        slot.hi.store(range.hi, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Function to pop the most recently pushed range (owner only)
+    bool pop(WsRange& range) {
+        long b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        read(b, range);
+        if (t == b) {
+            // Last element: race against thieves for it
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Function to steal the oldest range (any thread)
+    bool steal(WsRange& range) {
+        long t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        read(t, range);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<WsJob*> job;
+        std::atomic<long> lo;
+        std::atomic<long> hi;
+    };
+
+    void read(long index, WsRange& range) const {
+        const Slot& slot = slots_[index & (WS_DEQUE_CAPACITY - 1)];
+        range.job = slot.job.load(std::memory_order_relaxed);
+        range.lo = slot.lo.load(std::memory_order_relaxed);
+        range.hi = slot.hi.load(std::memory_order_relaxed);
+    }
+
+    // Padding keeps top (written by thieves) and bottom (written by the
+    // owner) on separate cache lines
+    std::atomic<long> top_;
+    char pad_top_[64];
+    std::atomic<long> bottom_;
+    char pad_bottom_[64];
+    Slot slots_[WS_DEQUE_CAPACITY];
+};
+
+// Value padded to its own cache line, for per-worker partial results
+template <class T>
+struct WsPadded {
+    T value;
+    char padding[64];
+};
+
+class WorkStealingPool {
+public:
+    // Function to start a pool of num_threads workers, including the thread
+    // that submits loops
+    explicit WorkStealingPool(int num_threads)
+        : size_(std::max(1, num_threads)), deques_(size_), job_(nullptr), stop_(false), parked_(0) {
+        for (int i = 1; i < size_; ++i) {
+            threads_.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(park_lock_);
+            stop_.store(true, std::memory_order_release);
+        }
+        park_cv_.notify_all();
+        for (std::thread& t : threads_) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return size_; }
+
+    // Function to get the index of the pool worker running on the calling
+    // thread, or -1 outside any pool (perf_counters.h and trace.h label
+    // threads with it, since pool workers are not OpenMP threads)
+    static int currentWorker() { return workerSlot(); }
+
+    // Function to run body(lo, hi, worker) over [begin, end) in ranges of at
+    // most grain iterations. grain <= 0 picks about 8 ranges per worker.
+    template <class Body>
+    void parallelFor(long begin, long end, long grain, const Body& body) {
+        if (end <= begin) return;
+        if (grain <= 0) grain = std::max(1L, (end - begin) / (8L * size_));
+
+        // Nested loops and single-worker pools run inline
+        if (currentWorker() >= 0 || size_ == 1 || end - begin <= grain) {
+            body(begin, end, std::max(0, currentWorker()));
+            return;
+        }
+
+        WsJob job;
+        job.run = &invoke<Body>;
+        job.body = &body;
+        job.grain = grain;
+        job.remaining.store(end - begin, std::memory_order_relaxed);
+
+        // Publish the job and wake parked workers
+        {
+            std::lock_guard<std::mutex> guard(park_lock_);
+            job_.store(&job, std::memory_order_release);
+        }
+        if (parked_.load(std::memory_order_relaxed) > 0) park_cv_.notify_all();
+
+        // The caller works as worker 0 until every iteration is done
+        workerSlot() = 0;
+        execute(WsRange{&job, begin, end}, 0);
+        WsRange range;
+        uint64_t rng = 0x9E3779B97F4A7C15ull;
+        int misses = 0;
+        while (job.remaining.load(std::memory_order_acquire) > 0) {
+            if (deques_[0].pop(range) || stealAny(0, rng, range)) execute(range, 0);
+            else backoff(++misses);
+        }
+        workerSlot() = -1;
+        job_.store(nullptr, std::memory_order_release);
+    }
+
+    // Function to reduce map(lo, hi, worker) over [begin, end) with combine.
+    // Partials are combined per worker first, then in worker order.
+    template <class T, class Map, class Combine>
+    T parallelReduce(long begin, long end, long grain, T identity, const Map& map, const Combine& combine) {
+        std::vector<WsPadded<T>> partials(size_);
+        for (WsPadded<T>& p : partials) p.value = identity;
+
+        parallelFor(begin, end, grain, [&](long lo, long hi, int worker) {
+            partials[worker].value = combine(partials[worker].value, map(lo, hi, worker));
+        });
+
+        T result = identity;
+        for (const WsPadded<T>& p : partials) result = combine(result, p.value);
+        return result;
+    }
+
+private:
+    template <class Body>
+    static void invoke(const void* body, long lo, long hi, int worker) {
+        (*static_cast<const Body*>(body))(lo, hi, worker);
+    }
+
+    // Index of the pool worker running on this thread, -1 outside the pool
+    static int& workerSlot() {
+        static thread_local int worker = -1;
+        return worker;
+    }
+
+    // Function to split a range down to the grain, queueing the upper halves,
+    // and run the remainder
+    void execute(WsRange range, int worker) {
+        WsJob* job = range.job;
+        while (range.hi - range.lo > job->grain) {
+            long mid = range.lo + (range.hi - range.lo) / 2;
+            if (!deques_[worker].push(WsRange{job, mid, range.hi})) break;
+            range.hi = mid;
+        }
+        job->run(job->body, range.lo, range.hi, worker);
+
+        // Last access to the job: once remaining hits zero the caller returns
+        job->remaining.fetch_sub(range.hi - range.lo, std::memory_order_acq_rel);
+    }
+
+    // Function to wait briefly after a failed steal round
+    static void backoff(int misses) {
+        if (misses % WS_YIELD_EVERY == 0) std::this_thread::yield();
+        else WS_POOL_PAUSE();
+    }
+
+    // Function to try every other worker's deque once, from a random start
+    bool stealAny(int self, uint64_t& rng, WsRange& range) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        int start = static_cast<int>(rng % size_);
+        for (int i = 0; i < size_; ++i) {
+            int victim = (start + i) % size_;
+            if (victim != self && deques_[victim].steal(range)) return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int self) {
+        workerSlot() = self;
+        uint64_t rng = 0x9E3779B97F4A7C15ull * (self + 1);
+        WsRange range;
+        int idle = 0;
+
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (deques_[self].pop(range) || stealAny(self, rng, range)) {
+                execute(range, self);
+                idle = 0;
+                continue;
+            }
+            if (++idle < WS_IDLE_SPINS || job_.load(std::memory_order_acquire) != nullptr) {
+                backoff(idle);
+                continue;
+            }
+
+            // No job for a while: park until the next one is published
+            std::unique_lock<std::mutex> lock(park_lock_);
+            parked_.fetch_add(1, std::memory_order_relaxed);
+            park_cv_.wait(lock, [this]() {
+                return stop_.load(std::memory_order_acquire) || job_.load(std::memory_order_acquire) != nullptr;
+            });
+            parked_.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    int size_;
+    std::vector<WsDeque> deques_;
+    std::vector<std::thread> threads_;
+    std::atomic<WsJob*> job_;
+    std::atomic<bool> stop_;
+    std::atomic<int> parked_;
+    std::mutex park_lock_;
+    std::condition_variable park_cv_;
+};
+
+#endif // WS_POOL_H
@@ -5,6 +5,8 @@
 #include <limits>
 #include <chrono>
 
+#include "kmeans_input.h"
+
 using namespace std;
 
 // Macro to calculate 2D index in a flattened 1D array
@@ -18,9 +20,11 @@ vector<float> dataSet;
 vector<float> centroids;
 vector<int> pointClusterMap;
 vector<int> clusterSizes;
+vector<float> newCentroids;   // Reused accumulation buffer for recalculateCentroids()
 int iterationCounter;
 
-// Function to read input data from a file
+// Function to read input data from a file (format in kmeans_input.h). Only
+// 2-D points are supported.
 void parseInputData(const string& filePath) {
     ifstream input(filePath);
     if (!input.is_open()) {
@@ -28,7 +32,17 @@ void parseInputData(const string& filePath) {
         exit(EXIT_FAILURE);
     }
 
-    input >> totalPoints;
+    int dims = 2;
+    string error;
+    if (!readKMeansHeader(input, totalPoints, dims, error)) {
+        cerr << "Error: Invalid input file: " << error << "." << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (dims != 2) {
+        cerr << "Error: Input has " << dims << " dimensions; kmeans_cpp_seq only supports 2 "
+             << "(use kmeans_omp_par)." << endl;
+        exit(EXIT_FAILURE);
+    }
     dataSet.resize(totalPoints * 2);
     for (long i = 0; i < totalPoints; ++i) {
         input >> dataSet[calcIndex(i, 0, 2)] >> dataSet[calcIndex(i, 1, 2)];
@@ -43,6 +57,7 @@ void initializeCentroids() {
         centroids[calcIndex(i, 0, 2)] = dataSet[calcIndex(i, 0, 2)];
         centroids[calcIndex(i, 1, 2)] = dataSet[calcIndex(i, 1, 2)];
     }
+    newCentroids.resize(clustersCount * 2);
 }
 
 // Function to assign points to the nearest cluster
@@ -76,7 +91,7 @@ bool updateClusterAssignments() {
 
 // Function to recalculate centroids
 void recalculateCentroids() {
-    vector<float> newCentroids(clustersCount * 2, 0.0);
+    newCentroids.assign(clustersCount * 2, 0.0f);
 
     for (long i = 0; i < totalPoints; ++i) {
         int clusterID = pointClusterMap[i];
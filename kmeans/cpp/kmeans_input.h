@@ -0,0 +1,42 @@
+#ifndef KMEANS_INPUT_H
+#define KMEANS_INPUT_H
+
+// Header of the K-means input format, shared by every reader: the first line
+// holds the number of points, optionally followed by the number of
+// dimensions (2 when absent, as in the original format). generate_kmeans_input
+// writes the dimension only for --dims other than 2; each following line
+// holds the coordinates of one point.
+//
+//   1000 3
+//   0.12 4.5 7.25
+//   ...
+
+#include <istream>
+#include <sstream>
+#include <string>
+
+// Function to read the header line. Returns false and fills in error if the
+// point count is missing or either value is not positive.
+inline bool readKMeansHeader(std::istream& input, long& n, int& d, std::string& error) {
+    std::string header;
+    std::getline(input, header);
+    std::istringstream fields(header);
+
+    n = 0;
+    d = 2;
+    if (!(fields >> n) || n <= 0) {
+        error = "the first line must hold a positive number of points";
+        return false;
+    }
+    int dims;
+    if (fields >> dims) {
+        if (dims <= 0) {
+            error = "the number of dimensions must be positive";
+            return false;
+        }
+        d = dims;
+    }
+    return true;
+}
+
+#endif // KMEANS_INPUT_H
@@ -1,41 +1,92 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <cmath>
 #include <cfloat>
+#include <algorithm>
 #include <chrono>
 #include <omp.h>
 
+#include "../../common/autotune.h"
+#include "../../common/fast_io.h"
+#include "../../common/numa_util.h"
+#include "../../common/perf_counters.h"
+#include "../../common/trace.h"
+#include "../../common/verify.h"
+#include "kmeans_input.h"
+#include "kmeans_workspace.h"
+
+#ifdef USE_WS_POOL
+#include <atomic>
+#include "../../common/ws_pool.h"
+#endif
+
 using namespace std;
 
-// Macro to calculate the 1D index in a 2D array
-#define IDX(i, j, N) ((i) * (N) + (j))
-
-// Global variables
-long N;                // Number of data points
-float* points;         // Array to store 2D points
-float* centroids;      // Array to store centroids
-int* clusters;         // Array to store cluster assignment of each point
-int* cluster_sizes;    // Array to store the size of each cluster
-int iterations;        // Number of iterations
-int K = 3;             // Default number of clusters
-int num_threads = 1;   // Default number of threads
-
-// Function to read input data from a file
-int readInputFile(const string& filename) {
+// Counter phases, reported when PERF_COUNTERS=1; traced under the same names
+static const int PHASE_ASSIGN = perfRegisterPhase("kmeans.assign");
+static const int PHASE_UPDATE = perfRegisterPhase("kmeans.update");
+
+// State of one clustering run: configuration plus the workspace it owns
+struct KMeansContext {
+    int K = 3;             // Default number of clusters
+    int num_threads = 1;   // Number of threads
+    int iterations = 0;    // Number of iterations
+    AssignMode assign_mode = AssignMode::Direct;
+    bool binary_output = false;     // Write the assignments as raw IDs
+    bool verify = false;            // Check the result after the run
+    AutotuneMode autotune = AutotuneMode::Cache;
+    bool numa_first_touch = false;  // Touch buffers with the compute loops' schedule
+    bool numa_report = false;       // Print per-node page placement
+    PinMode pin_mode = PinMode::None;
+    KMeansWorkspace ws;
+#ifdef USE_WS_POOL
+    WorkStealingPool* pool = nullptr;   // Runs the assignment step instead of OpenMP
+#endif
+};
+
+// Function to read input data from a file (format in kmeans_input.h)
+int readInputFile(KMeansContext& ctx, const string& filename) {
     ifstream input(filename);
     if (!input.is_open()) {
         cerr << "Error: Unable to open input file." << endl;
         return 1;
     }
 
-    // Read the number of points
-    input >> N;
+    // Read the number of points and dimensions
+    long N = 0;
+    int D = 2;
+    string error;
+    if (!readKMeansHeader(input, N, D, error)) {
+        cerr << "Error: Invalid input file: " << error << "." << endl;
+        return 1;
+    }
+    if (N < ctx.K) {
+        cerr << "Error: Number of points must be at least the number of clusters." << endl;
+        return 1;
+    }
+
+    // Allocate the whole workspace up front
+    ctx.ws.allocate(N, D, ctx.K, ctx.num_threads, ctx.assign_mode);
+
+    float* points = ctx.ws.points;
+    int* clusters = ctx.ws.clusters;
+
+    // The buffers are not touched yet, so in NUMA mode let each thread fault
+    // in the pages it will later work on before the sequential read fills them
+    if (ctx.numa_first_touch) {
+        #pragma omp parallel for num_threads(ctx.num_threads) schedule(static)
+        for (long i = 0; i < N; ++i) {
+            for (int d = 0; d < D; ++d) {
+                points[IDX(i, d, D)] = 0.0f;
+            }
+            clusters[i] = -1;
+        }
+    }
 
-    // Allocate memory for points
-    points = new float[N * 2];
-    for (long i = 0; i < N; ++i) {
-        input >> points[IDX(i, 0, 2)] >> points[IDX(i, 1, 2)];
+    for (long i = 0; i < N * D; ++i) {
+        input >> points[i];
     }
 
     input.close();
@@ -43,124 +94,239 @@ int readInputFile(const string& filename) {
 }
 
 // Function to initialize centroids with the first K points
-void initializeCentroids() {
-    centroids = new float[K * 2];
-    for (int i = 0; i < K; ++i) {
-        centroids[IDX(i, 0, 2)] = points[IDX(i, 0, 2)];
-        centroids[IDX(i, 1, 2)] = points[IDX(i, 1, 2)];
+void initializeCentroids(KMeansContext& ctx) {
+    KMeansWorkspace& ws = ctx.ws;
+    for (long i = 0; i < (long)ws.K * ws.D; ++i) {
+        ws.centroids[i] = ws.points[i];
+    }
+    for (long i = 0; i < ws.N; ++i) {
+        ws.clusters[i] = -1;
+    }
+
+    // Point norms for the GEMM assignment never change
+    if (ctx.assign_mode == AssignMode::Gemm) {
+        #pragma omp parallel for num_threads(ctx.num_threads) schedule(static)
+        for (long i = 0; i < ws.N; ++i) {
+            ws.point_norms[i] = pointNorm(ws, i);
+        }
     }
 }
 
-// Function to assign points to the closest centroid
-bool assignPointsToClusters() {
-    // Reset cluster sizes
-    cluster_sizes = new int[K]();
+// Function to assign points to the closest centroid. Each thread also
+// accumulates the coordinate sums and sizes of the clusters it assigned into
+// its own slice of the workspace, so no atomics are needed.
+bool assignPointsToClusters(KMeansContext& ctx) {
+    KMeansWorkspace& ws = ctx.ws;
+    const long N = ws.N;
     bool hasChanged = false;
 
-    // Parallelize the loop to assign points
-    #pragma omp parallel for num_threads(num_threads) shared(points, centroids, clusters, cluster_sizes) reduction(||:hasChanged)
-    for (long i = 0; i < N; ++i) {
-        float min_distance = FLT_MAX;
-        int closest_centroid = -1;
-
-        // Find the closest centroid
-        for (int j = 0; j < K; ++j) {
-            float dx = centroids[IDX(j, 0, 2)] - points[IDX(i, 0, 2)];
-            float dy = centroids[IDX(j, 1, 2)] - points[IDX(i, 1, 2)];
-            float distance = dx * dx + dy * dy;
-
-            if (distance < min_distance) {
-                min_distance = distance;
-                closest_centroid = j;
-            }
+    if (ctx.assign_mode == AssignMode::Gemm) prepareGemmCentroids(ws);
+
+    // Cleared up front rather than by each thread, so the slots of threads
+    // the runtime did not start (OMP_THREAD_LIMIT, OMP_DYNAMIC) hold zeros
+    // when updateCentroids() reduces over all of them
+    std::fill(ws.sums, ws.sums + (long)ws.num_threads * ws.sums_stride, 0.0);
+    std::fill(ws.counts, ws.counts + (long)ws.num_threads * ws.sums_stride, 0L);
+
+#ifdef USE_WS_POOL
+    // Partial sums are indexed by pool worker instead of OpenMP thread
+    std::atomic<bool> changed(false);
+    ctx.pool->parallelFor(0, N, 0, [&](long lo, long hi, int worker) {
+        PerfScope perf(PHASE_ASSIGN);
+        TRACE_SCOPE("kmeans.assign");
+        double* sums = ws.sums + (long)worker * ws.sums_stride;
+        long* counts = ws.counts + (long)worker * ws.sums_stride;
+        if (assignRangeWith(ws, ctx.assign_mode, lo, hi, sums, counts, worker)) {
+            changed.store(true, std::memory_order_relaxed);
         }
-
-        // Check if the cluster assignment has changed
-        if (clusters[i] != closest_centroid) {
-            clusters[i] = closest_centroid;
-            hasChanged = true;
-        }
-
-        // Increment the size of the cluster
-        #pragma omp atomic
-        cluster_sizes[closest_centroid]++;
+    });
+    hasChanged = changed.load(std::memory_order_relaxed);
+#else
+    #pragma omp parallel num_threads(ws.num_threads) reduction(||:hasChanged)
+    {
+        PerfScope perf(PHASE_ASSIGN);
+        TRACE_SCOPE("kmeans.assign");
+        double* sums = ws.sums + (long)omp_get_thread_num() * ws.sums_stride;
+        long* counts = ws.counts + (long)omp_get_thread_num() * ws.sums_stride;
+
+        // Contiguous block per thread, the same split as schedule(static)
+        long thread_id = omp_get_thread_num();
+        long thread_count = omp_get_num_threads();
+        hasChanged = assignRangeWith(ws, ctx.assign_mode, N * thread_id / thread_count,
+                                     N * (thread_id + 1) / thread_count, sums, counts, (int)thread_id);
     }
+#endif
     return hasChanged;
 }
 
-// Function to update centroids based on assigned points
-void updateCentroids() {
-    vector<float> new_centroids(K * 2, 0.0);
-
-    // Accumulate the points in each cluster
-    #pragma omp parallel for
-    for (long i = 0; i < N; ++i) {
-        int cluster_id = clusters[i];
-        #pragma omp atomic
-        new_centroids[IDX(cluster_id, 0, 2)] += points[IDX(i, 0, 2)];
-        #pragma omp atomic
-        new_centroids[IDX(cluster_id, 1, 2)] += points[IDX(i, 1, 2)];
-    }
-
-    // Compute the new centroids
-    #pragma omp parallel for
-    for (int j = 0; j < K; ++j) {
-        if (cluster_sizes[j] > 0) {
-            centroids[IDX(j, 0, 2)] = new_centroids[IDX(j, 0, 2)] / cluster_sizes[j];
-            centroids[IDX(j, 1, 2)] = new_centroids[IDX(j, 1, 2)] / cluster_sizes[j];
-        }
-    }
+// Function to update centroids by reducing the per-thread partial sums
+void updateCentroids(KMeansContext& ctx) {
+    PerfScope perf(PHASE_UPDATE);
+    TRACE_SCOPE("kmeans.update");
+    reduceCentroids(ctx.ws);
 }
 
-// Function to print the results to a file
-void printResults(const string& filename) {
-    ofstream output(filename);
-    if (!output.is_open()) {
+// Function to print the results to a file. The header and centroids are
+// small and go through a stringstream; the N cluster IDs are formatted and
+// written by all threads at once (fast_io.h). In binary mode the
+// assignment line names the ID type and is followed by N raw IDs instead of
+// text.
+void printResults(const KMeansContext& ctx, const string& filename) {
+    const KMeansWorkspace& ws = ctx.ws;
+    PositionedFile output;
+    string error;
+    if (!output.open(filename, error)) {
         cerr << "Error: Unable to open output file." << endl;
         return;
     }
 
     // Output the number of iterations and points
-    output << "Total Iterations: " << iterations << "\n";
-    output << "Number of Points: " << N << "\n";
+    ostringstream header;
+    header << "Total Iterations: " << ctx.iterations << "\n";
+    header << "Number of Points: " << ws.N << "\n";
 
     // Output the centroids
-    output << "Centroids:\n";
-    for (int i = 0; i < K; ++i) {
-        output << centroids[IDX(i, 0, 2)] << ", " << centroids[IDX(i, 1, 2)] << "\n";
+    header << "Centroids:\n";
+    for (int i = 0; i < ws.K; ++i) {
+        for (int d = 0; d < ws.D; ++d) {
+            if (d > 0) header << ", ";
+            header << ws.centroids[IDX(i, d, ws.D)];
+        }
+        header << "\n";
     }
 
     // Output the cluster assignments
-    output << "Point Assignments:\n";
-    for (long i = 0; i < N; ++i) {
-        output << clusters[i];
-        if (i < N - 1) output << " ";
+    const bool narrow = ws.K <= 65536;
+    if (ctx.binary_output) {
+        header << "Point Assignments (" << (narrow ? "uint16" : "uint32") << "):\n";
+    } else {
+        header << "Point Assignments:\n";
+    }
+    const string text = header.str();
+    off_t end = output.writeAt(text.data(), text.size(), 0) ? (off_t)text.size() : -1;
+    if (end >= 0 && ctx.binary_output) {
+        end = narrow ? writeIdsBinary<uint16_t>(output, end, ws.clusters, ws.N, ctx.num_threads)
+                     : writeIdsBinary<uint32_t>(output, end, ws.clusters, ws.N, ctx.num_threads);
+    } else if (end >= 0) {
+        end = ws.N > 0 ? writeIdsText(output, end, ws.clusters, ws.N, ctx.num_threads)
+                       : (output.writeAt("\n", 1, end) ? end + 1 : -1);
     }
-    output << "\n";
 
-    output.close();
+    if (end < 0 || !output.close()) {
+        cerr << "Error: Unable to write output file." << endl;
+    }
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
-        cerr << "Usage: " << argv[0] << " <input_file> <output_file> [num_clusters] [num_threads]" << endl;
+    KMeansContext ctx;
+    ctx.num_threads = omp_get_max_threads();
+
+    // Split the --options from the positional arguments
+    vector<string> args;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--verify") {
+            ctx.verify = true;
+        } else if (parseAutotuneFlag(arg, ctx.autotune)) {
+            continue;
+        } else if (arg == "--numa") {
+            ctx.numa_first_touch = true;
+        } else if (arg == "--numa-report") {
+            ctx.numa_report = true;
+        } else if (arg.rfind("--pin=", 0) == 0) {
+            if (!parsePinMode(arg.substr(6), ctx.pin_mode)) {
+                cerr << "Error: Unknown pinning mode " << arg.substr(6) << endl;
+                return 1;
+            }
+        } else if (arg.rfind("--output-format=", 0) == 0) {
+            string format = arg.substr(16);
+            if (format == "text") {
+                ctx.binary_output = false;
+            } else if (format == "binary") {
+                ctx.binary_output = true;
+            } else {
+                cerr << "Error: Unknown output format " << format << endl;
+                return 1;
+            }
+        } else if (arg.rfind("--assign=", 0) == 0) {
+            string mode = arg.substr(9);
+            if (mode == "direct") {
+                ctx.assign_mode = AssignMode::Direct;
+            } else if (mode == "gemm") {
+                ctx.assign_mode = AssignMode::Gemm;
+            } else {
+                cerr << "Error: Unknown assignment mode " << mode << endl;
+                return 1;
+            }
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 2) {
+        cerr << "Usage: " << argv[0] << " <input_file> <output_file> [num_clusters] [num_threads]"
+             << " [--assign=direct|gemm] [--output-format=text|binary] [--verify] [--autotune[=off]] [--numa] [--pin=compact|scatter] [--numa-report]" << endl;
         return 1;
     }
 
-    string input_file = argv[1];
-    string output_file = argv[2];
+    string input_file = args[0];
+    string output_file = args[1];
 
     // Read number of clusters and threads if provided
-    if (argc > 3) K = stoi(argv[3]);
-    if (argc > 4) num_threads = stoi(argv[4]);
+    if (args.size() > 2) ctx.K = stoi(args[2]);
+    if (args.size() > 3) ctx.num_threads = stoi(args[3]);
+    if (ctx.K <= 0 || ctx.num_threads <= 0) {
+        cerr << "Error: Number of clusters and threads must be positive." << endl;
+        return 1;
+    }
 
-    // Read input data
-    if (readInputFile(input_file)) return 1;
+    // Pin the team before any buffer is first touched
+    pinThreads(ctx.pin_mode, ctx.num_threads);
+
+    // Read input data into a freshly allocated workspace
+    if (readInputFile(ctx, input_file)) return 1;
+
+    if (ctx.numa_report) {
+        NumaPlacement points_placement, clusters_placement;
+        points_placement.addRange(ctx.ws.points, ctx.ws.N * ctx.ws.D * sizeof(float));
+        clusters_placement.addRange(ctx.ws.clusters, ctx.ws.N * sizeof(int));
+        points_placement.print("points");
+        clusters_placement.print("clusters");
+    }
+
+#ifdef USE_WS_POOL
+    WorkStealingPool pool(ctx.num_threads);
+    ctx.pool = &pool;
+#endif
 
     // Initialize centroids and clusters
-    initializeCentroids();
-    clusters = new int[N]();
-    iterations = 0;
+    initializeCentroids(ctx);
+    ctx.iterations = 0;
+
+    // The GEMM tile sizes are searched with --autotune, timing assignment
+    // steps from the initial centroids, and otherwise taken from the cache.
+    // The tuning steps are dropped from the counters and the trace.
+    if (ctx.assign_mode == AssignMode::Gemm) {
+        Autotuner tuner("kmeans_gemm", ctx.ws.N);
+        tuner.addParam("point_block", {16, 32, 64}, ctx.ws.point_block);
+        tuner.addParam("centroid_block", {64, 128, 256}, ctx.ws.centroid_block);
+        auto apply = [&]() {
+            ctx.ws.point_block = max(1L, min(tuner.get("point_block"), (long)ASSIGN_POINT_BLOCK));
+            ctx.ws.centroid_block = max(1L, min(tuner.get("centroid_block"), (long)ASSIGN_CENTROID_BLOCK));
+        };
+        if (ctx.autotune == AutotuneMode::Tune) {
+            tuner.tune([&]() {
+                apply();
+                assignPointsToClusters(ctx);
+            }, cerr);
+            initializeCentroids(ctx);
+            perfReset();
+            traceReset();
+        } else if (ctx.autotune == AutotuneMode::Cache && tuner.load()) {
+            cerr << "Autotune: using " << tuner.describe() << " from " << tuner.path() << endl;
+        }
+        apply();
+    }
 
     // Measure execution time
     auto start_time = chrono::high_resolution_clock::now();
@@ -168,26 +334,32 @@ int main(int argc, char* argv[]) {
     // Perform K-Means clustering
     bool hasChanged = true;
     while (hasChanged) {
-        hasChanged = assignPointsToClusters();
-        updateCentroids();
-        iterations++;
+        hasChanged = assignPointsToClusters(ctx);
+        updateCentroids(ctx);
+        ctx.iterations++;
     }
 
     auto end_time = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::microseconds>(end_time - start_time).count();
 
     // Output results
-    printResults(output_file);
+    printResults(ctx, output_file);
 
     // Print execution details
     std::cout <<duration<< std::endl;
-
-
-    // Clean up memory
-    delete[] points;
-    delete[] centroids;
-    delete[] clusters;
-    delete[] cluster_sizes;
+    perfReport(cerr);
+    TRACE_WRITE();
+
+    // Check that the result is a fixed point of the algorithm
+    if (ctx.verify) {
+        string error;
+        if (!kmeansConsistency(ctx.ws.points, ctx.ws.clusters, ctx.ws.N, ctx.ws.D, ctx.ws.centroids, ctx.K,
+                               ctx.num_threads, error)) {
+            cerr << "Verification failed: " << error << endl;
+            return 1;
+        }
+        cerr << "Verification passed" << endl;
+    }
 
     return 0;
 }
@@ -207,4 +379,4 @@ gcc -o kmeans_omp_par kmeans_omp_par.cpp -lstdc++ -lm -std=c++11 -fopenmp
 ./kmeans_omp_par input_100000.txt out100000_omp_par 10
 ./kmeans_omp_par input_1000000.txt out1000000_omp_par 10
 time ./kmeans_omp_par input_1000.txt out1000_omp_par 10
-*/
\ No newline at end of file
+*/
@@ -0,0 +1,220 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cfloat>
+#include <chrono>
+#include <algorithm>
+#include <execution>
+#include <numeric>
+
+#include "../../common/stdpar_util.h"
+#include "kmeans_input.h"
+
+using namespace std;
+
+// Compilation Instructions:
+// g++ -O3 -std=c++17 -o kmeans_stdpar kmeans_stdpar.cpp -ltbb
+
+// Macro to calculate 2D index in a flattened 1D array
+#define IDX(i, j, cols) ((i) * (cols) + (j))
+
+// Points per chunk of the assignment step. Each chunk accumulates its own
+// partial sums and the chunks are reduced in order, so the centroids do not
+// depend on the thread count.
+#define KMEANS_CHUNK 8192
+
+// State of one clustering run
+struct KMeansState {
+    long N = 0;                 // Number of points
+    int K = 3;                  // Default number of clusters
+    int iterations = 0;         // Number of iterations
+    vector<float> points;       // N x 2 coordinates
+    vector<float> centroids;    // K x 2 coordinates
+    vector<int> clusters;       // Cluster of each point
+    long chunks = 0;            // Number of assignment chunks
+    vector<double> sums;        // chunks x (K x 2) coordinate sums
+    vector<long> counts;        // chunks x K cluster sizes
+};
+
+// Function to read input data from a file (format in kmeans_input.h). Only
+// 2-D points are supported.
+int readInputFile(KMeansState& st, const string& filename) {
+    ifstream input(filename);
+    if (!input.is_open()) {
+        cerr << "Error: Unable to open input file." << endl;
+        return 1;
+    }
+
+    int dims = 2;
+    string error;
+    if (!readKMeansHeader(input, st.N, dims, error)) {
+        cerr << "Error: Invalid input file: " << error << "." << endl;
+        return 1;
+    }
+    if (dims != 2) {
+        cerr << "Error: Input has " << dims << " dimensions; kmeans_stdpar only supports 2 "
+             << "(use kmeans_omp_par)." << endl;
+        return 1;
+    }
+    if (st.N < st.K) {
+        cerr << "Error: Number of points must be at least the number of clusters." << endl;
+        return 1;
+    }
+
+    st.points.resize(st.N * 2);
+    for (long i = 0; i < st.N; ++i) {
+        input >> st.points[IDX(i, 0, 2)] >> st.points[IDX(i, 1, 2)];
+    }
+
+    st.chunks = (st.N + KMEANS_CHUNK - 1) / KMEANS_CHUNK;
+    st.sums.resize(st.chunks * st.K * 2);
+    st.counts.resize(st.chunks * st.K);
+
+    input.close();
+    return 0;
+}
+
+// Function to initialize centroids with the first K points
+void initializeCentroids(KMeansState& st) {
+    st.centroids.resize(st.K * 2);
+    for (int i = 0; i < st.K; ++i) {
+        st.centroids[IDX(i, 0, 2)] = st.points[IDX(i, 0, 2)];
+        st.centroids[IDX(i, 1, 2)] = st.points[IDX(i, 1, 2)];
+    }
+    st.clusters.assign(st.N, -1);
+}
+
+// Function to assign points to the closest centroid. Chunks run in parallel
+// and report whether any of their assignments changed.
+bool assignPointsToClusters(KMeansState& st) {
+    const long N = st.N;
+    const int K = st.K;
+    const float* points = st.points.data();
+    const float* centroids = st.centroids.data();
+    int* clusters = st.clusters.data();
+    double* all_sums = st.sums.data();
+    long* all_counts = st.counts.data();
+
+    return transform_reduce(execution::par, CountingIterator(0), CountingIterator(st.chunks), false,
+        [](bool a, bool b) { return a || b; },
+        [=](long chunk) {
+            double* sums = all_sums + chunk * K * 2;
+            long* counts = all_counts + chunk * K;
+            fill(sums, sums + K * 2, 0.0);
+            fill(counts, counts + K, 0L);
+
+            bool hasChanged = false;
+            long end = min(N, (chunk + 1) * KMEANS_CHUNK);
+            for (long i = chunk * KMEANS_CHUNK; i < end; ++i) {
+                float px = points[IDX(i, 0, 2)];
+                float py = points[IDX(i, 1, 2)];
+                float min_distance = FLT_MAX;
+                int closest_centroid = -1;
+
+                // Find the closest centroid
+                for (int j = 0; j < K; ++j) {
+                    float dx = centroids[IDX(j, 0, 2)] - px;
+                    float dy = centroids[IDX(j, 1, 2)] - py;
+                    float distance = dx * dx + dy * dy;
+
+                    if (distance < min_distance) {
+                        min_distance = distance;
+                        closest_centroid = j;
+                    }
+                }
+
+                if (clusters[i] != closest_centroid) {
+                    clusters[i] = closest_centroid;
+                    hasChanged = true;
+                }
+
+                sums[IDX(closest_centroid, 0, 2)] += px;
+                sums[IDX(closest_centroid, 1, 2)] += py;
+                counts[closest_centroid]++;
+            }
+            return hasChanged;
+        });
+}
+
+// Function to update centroids by reducing the per-chunk partial sums in order
+void updateCentroids(KMeansState& st) {
+    for (int j = 0; j < st.K; ++j) {
+        double sum_x = 0.0, sum_y = 0.0;
+        long size = 0;
+        for (long c = 0; c < st.chunks; ++c) {
+            sum_x += st.sums[c * st.K * 2 + IDX(j, 0, 2)];
+            sum_y += st.sums[c * st.K * 2 + IDX(j, 1, 2)];
+            size += st.counts[c * st.K + j];
+        }
+        if (size > 0) {
+            st.centroids[IDX(j, 0, 2)] = static_cast<float>(sum_x / size);
+            st.centroids[IDX(j, 1, 2)] = static_cast<float>(sum_y / size);
+        }
+    }
+}
+
+// Function to print the results to a file
+void printResults(const KMeansState& st, const string& filename) {
+    ofstream output(filename);
+    if (!output.is_open()) {
+        cerr << "Error: Unable to open output file." << endl;
+        return;
+    }
+
+    output << "Total Iterations: " << st.iterations << "\n";
+    output << "Number of Points: " << st.N << "\n";
+
+    output << "Centroids:\n";
+    for (int i = 0; i < st.K; ++i) {
+        output << st.centroids[IDX(i, 0, 2)] << ", " << st.centroids[IDX(i, 1, 2)] << "\n";
+    }
+
+    output << "Point Assignments:\n";
+    for (long i = 0; i < st.N; ++i) {
+        output << st.clusters[i];
+        if (i < st.N - 1) output << " ";
+    }
+    output << "\n";
+
+    output.close();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 5) {
+        cerr << "Usage: " << argv[0] << " <input_file> <output_file> [num_clusters] [num_threads]" << endl;
+        return 1;
+    }
+
+    KMeansState st;
+    string input_file = argv[1];
+    string output_file = argv[2];
+    int num_threads = 0;   // Default: all cores
+    if (argc > 3) st.K = stoi(argv[3]);
+    if (argc > 4) num_threads = stoi(argv[4]);
+    if (st.K <= 0 || (argc > 4 && num_threads <= 0)) {
+        cerr << "Error: Number of clusters and threads must be positive." << endl;
+        return 1;
+    }
+    ParallelismLimit limit(num_threads);
+
+    if (readInputFile(st, input_file)) return 1;
+    initializeCentroids(st);
+
+    auto start_time = chrono::high_resolution_clock::now();
+
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = assignPointsToClusters(st);
+        updateCentroids(st);
+        st.iterations++;
+    }
+
+    auto end_time = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::microseconds>(end_time - start_time).count();
+
+    printResults(st, output_file);
+
+    std::cout <<duration<< std::endl;
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+#ifndef KMEANS_WORKSPACE_H
+#define KMEANS_WORKSPACE_H
+
+// Buffers and per-thread kernels of the parallel K-means step, shared by
+// kmeans_omp_par and the library API (api/kernels.h). The callers own the
+// parallel region: each thread assigns a contiguous range of points with
+// assignRangeWith() into its own slice of the partial sums, and
+// reduceCentroids() turns the slices into the new centroids afterwards.
+
+#include <algorithm>
+#include <cfloat>
+
+#include "../../common/blocked_gemm.h"
+
+// Macro to calculate the 1D index in a 2D array
+#define IDX(i, j, N) ((i) * (N) + (j))
+
+// Per-thread partial sums are padded to a multiple of this many doubles so
+// that two threads never write to the same cache line
+#define CACHE_LINE_DOUBLES 8
+
+// Largest tile of the point-to-centroid distance matrix computed at once by
+// the GEMM assignment: points x centroids. The tile used is tunable up to
+// these sizes.
+#define ASSIGN_POINT_BLOCK 64
+#define ASSIGN_CENTROID_BLOCK 256
+
+// How points are assigned to centroids
+enum class AssignMode {
+    Direct,   // Per point, a loop over the centroids
+    Gemm      // Blocks of ||x||^2 - 2 x.c + ||c||^2 through a blocked GEMM
+};
+
+// Buffers used by the clustering loop. Everything is allocated once when the
+// input size is known, so no memory is allocated inside the iteration loop.
+struct KMeansWorkspace {
+    long N = 0;                // Number of data points
+    int D = 2;                 // Number of dimensions
+    int K = 0;                 // Number of clusters
+    int num_threads = 1;       // Number of threads sharing the partial buffers
+    int sums_stride = 0;       // Padded length of one thread's partial sums
+
+    float* points = nullptr;     // N x D input points
+    float* centroids = nullptr;  // K x D current centroids
+    int* clusters = nullptr;     // Cluster assignment of each point
+    double* sums = nullptr;      // num_threads x sums_stride coordinate sums
+    long* counts = nullptr;      // num_threads x sums_stride cluster sizes
+
+    // GEMM assignment only
+    float* centroids_t = nullptr;     // D x K transposed centroids
+    float* point_norms = nullptr;     // ||x||^2 per point
+    float* centroid_norms = nullptr;  // ||c||^2 per centroid
+    float* tiles = nullptr;           // num_threads distance tiles
+    long point_block = ASSIGN_POINT_BLOCK;        // Tile rows in use
+    long centroid_block = ASSIGN_CENTROID_BLOCK;  // Tile columns in use
+
+    KMeansWorkspace() = default;
+    KMeansWorkspace(const KMeansWorkspace&) = delete;
+    KMeansWorkspace& operator=(const KMeansWorkspace&) = delete;
+
+    // Function to (re)allocate every buffer for the given sizes. The point
+    // and centroid contents are not preserved.
+    void allocate(long n, int d, int k, int threads, AssignMode mode) {
+        release();
+        N = n;
+        D = d;
+        K = k;
+        num_threads = threads;
+        sums_stride = ((K * D + CACHE_LINE_DOUBLES - 1) / CACHE_LINE_DOUBLES) * CACHE_LINE_DOUBLES;
+
+        points = new float[N * D];
+        centroids = new float[(long)K * D];
+        clusters = new int[N];
+        sums = new double[(long)num_threads * sums_stride];
+        counts = new long[(long)num_threads * sums_stride];
+
+        if (mode == AssignMode::Gemm) {
+            centroids_t = new float[(long)D * K];
+            point_norms = new float[N];
+            centroid_norms = new float[K];
+            tiles = new float[(long)num_threads * ASSIGN_POINT_BLOCK * ASSIGN_CENTROID_BLOCK];
+        }
+    }
+
+    ~KMeansWorkspace() { release(); }
+
+private:
+    void release() {
+        delete[] points;
+        delete[] centroids;
+        delete[] clusters;
+        delete[] sums;
+        delete[] counts;
+        delete[] centroids_t;
+        delete[] point_norms;
+        delete[] centroid_norms;
+        delete[] tiles;
+        points = centroids = centroids_t = point_norms = centroid_norms = tiles = nullptr;
+        clusters = nullptr;
+        sums = nullptr;
+        counts = nullptr;
+    }
+};
+
+// Function to compute ||x||^2 of point i, for the GEMM assignment
+inline float pointNorm(const KMeansWorkspace& ws, long i) {
+    float norm = 0.0f;
+    for (int d = 0; d < ws.D; ++d) {
+        norm += ws.points[IDX(i, d, ws.D)] * ws.points[IDX(i, d, ws.D)];
+    }
+    return norm;
+}
+
+// Function to record point i in cluster c and add it to the given partial
+// sums. Returns whether its assignment changed.
+inline bool recordAssignment(KMeansWorkspace& ws, long i, int c, int D, double* sums, long* counts) {
+    bool changed = ws.clusters[i] != c;
+    ws.clusters[i] = c;
+    for (int d = 0; d < D; ++d) {
+        sums[IDX(c, d, D)] += ws.points[IDX(i, d, D)];
+    }
+    counts[c]++;
+    return changed;
+}
+
+// Function to assign points [begin, end) to the closest centroid and add
+// them to the given partial sums. Returns whether any assignment changed.
+// FixedD > 0 makes the dimension a compile-time constant (the 2-D inputs the
+// benchmarks use); 0 takes it from the workspace.
+template <int FixedD>
+bool assignRange(KMeansWorkspace& ws, long begin, long end, double* sums, long* counts) {
+    const int D = FixedD > 0 ? FixedD : ws.D;
+    const int K = ws.K;
+    const float* points = ws.points;
+    const float* centroids = ws.centroids;
+    bool hasChanged = false;
+
+    for (long i = begin; i < end; ++i) {
+        const float* p = points + IDX(i, 0, D);
+        float min_distance = FLT_MAX;
+        int closest_centroid = -1;
+
+        // Find the closest centroid
+        for (int j = 0; j < K; ++j) {
+            float distance = 0.0f;
+            for (int d = 0; d < D; ++d) {
+                float diff = centroids[IDX(j, d, D)] - p[d];
+                distance += diff * diff;
+            }
+
+            if (distance < min_distance) {
+                min_distance = distance;
+                closest_centroid = j;
+            }
+        }
+
+        // Check if the cluster assignment has changed and accumulate the
+        // point into this thread's partial sums
+        if (recordAssignment(ws, i, closest_centroid, D, sums, counts)) hasChanged = true;
+    }
+    return hasChanged;
+}
+
+// Function to assign points [begin, end) like assignRange, computing the
+// distances one tile at a time as ||x||^2 - 2 x.c + ||c||^2. The x.c terms
+// of a tile come from the blocked GEMM kernel and the argmin is taken while
+// the tile is still in cache, so the N x K distance matrix never exists.
+inline bool assignRangeGemm(KMeansWorkspace& ws, long begin, long end, double* sums, long* counts, float* tile) {
+    const int D = ws.D;
+    const int K = ws.K;
+    bool hasChanged = false;
+
+    for (long i0 = begin; i0 < end; i0 += ws.point_block) {
+        const long rows = std::min(end - i0, ws.point_block);
+        float best_distance[ASSIGN_POINT_BLOCK];
+        int best_centroid[ASSIGN_POINT_BLOCK];
+        for (long i = 0; i < rows; ++i) {
+            best_distance[i] = FLT_MAX;
+            best_centroid[i] = -1;
+        }
+
+        for (int j0 = 0; j0 < K; j0 += ws.centroid_block) {
+            const long cols = std::min((long)K - j0, ws.centroid_block);
+
+            // tile = X[i0 .. i0 + rows) * C^T[:, j0 .. j0 + cols)
+            for (long t = 0; t < rows * cols; ++t) {
+                tile[t] = 0.0f;
+            }
+            gemmTile(0, rows, 0, cols, D, ws.points + IDX(i0, 0, D), D, ws.centroids_t + j0, K, tile, cols);
+
+            // Epilogue: distances and the running argmin of every point
+            for (long i = 0; i < rows; ++i) {
+                const float x_norm = ws.point_norms[i0 + i];
+                const float* dots = tile + i * cols;
+                for (long j = 0; j < cols; ++j) {
+                    float distance = x_norm - 2.0f * dots[j] + ws.centroid_norms[j0 + j];
+                    if (distance < best_distance[i]) {
+                        best_distance[i] = distance;
+                        best_centroid[i] = j0 + (int)j;
+                    }
+                }
+            }
+        }
+
+        for (long i = 0; i < rows; ++i) {
+            if (recordAssignment(ws, i0 + i, best_centroid[i], D, sums, counts)) hasChanged = true;
+        }
+    }
+    return hasChanged;
+}
+
+// Function to assign points [begin, end) with the given method. thread picks
+// the GEMM distance tile, so every concurrent caller needs its own.
+inline bool assignRangeWith(KMeansWorkspace& ws, AssignMode mode, long begin, long end, double* sums, long* counts,
+                            int thread) {
+    if (mode == AssignMode::Gemm) {
+        float* tile = ws.tiles + (long)thread * ASSIGN_POINT_BLOCK * ASSIGN_CENTROID_BLOCK;
+        return assignRangeGemm(ws, begin, end, sums, counts, tile);
+    }
+    return ws.D == 2 ? assignRange<2>(ws, begin, end, sums, counts)
+                     : assignRange<0>(ws, begin, end, sums, counts);
+}
+
+// Function to prepare the per-iteration centroid data of the GEMM assignment:
+// the transposed centroids and their squared norms
+inline void prepareGemmCentroids(KMeansWorkspace& ws) {
+    for (int j = 0; j < ws.K; ++j) {
+        float norm = 0.0f;
+        for (int d = 0; d < ws.D; ++d) {
+            float c = ws.centroids[IDX(j, d, ws.D)];
+            ws.centroids_t[IDX(d, j, ws.K)] = c;
+            norm += c * c;
+        }
+        ws.centroid_norms[j] = norm;
+    }
+}
+
+// Function to move each centroid to the mean of its points by reducing the
+// per-thread partial sums in thread order. Empty clusters keep their centroid.
+inline void reduceCentroids(KMeansWorkspace& ws) {
+    for (int j = 0; j < ws.K; ++j) {
+        long size = 0;
+        for (int t = 0; t < ws.num_threads; ++t) {
+            size += ws.counts[(long)t * ws.sums_stride + j];
+        }
+        if (size == 0) continue;
+
+        for (int d = 0; d < ws.D; ++d) {
+            double sum = 0.0;
+            for (int t = 0; t < ws.num_threads; ++t) {
+                sum += ws.sums[(long)t * ws.sums_stride + IDX(j, d, ws.D)];
+            }
+            ws.centroids[IDX(j, d, ws.D)] = static_cast<float>(sum / size);
+        }
+    }
+}
+
+#endif // KMEANS_WORKSPACE_H
@@ -1,53 +1,130 @@
 #include <iostream>
-#include <fstream>
 #include <random>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+#include "../common/fast_io.h"
+#include "../common/philox.h"
 
 using namespace std;
 
-// Function to generate random points and write to a file
-void generate_kmeans_input(int n) {
-    // Create the filename based on n
-    string filename = "input_" + to_string(n) + ".txt";
-    ofstream output_file(filename);
+// Each coordinate is written as a fixed-width field "%9.3f" plus a separator,
+// so point i starts at a known offset and chunks of points can be generated
+// and written by any thread in any order
+#define COORD_WIDTH 9
+#define FIELD_BYTES (COORD_WIDTH + 1)
+
+// Points per chunk handed to a thread
+#define POINT_CHUNK 65536
 
-    if (!output_file.is_open()) {
+// Function to write milli / 1000 with 3 decimals, right-aligned in
+// COORD_WIDTH characters
+inline void formatCoordinate(char* out, int32_t milli) {
+    const bool negative = milli < 0;
+    uint32_t value = negative ? (uint32_t)(-milli) : (uint32_t)milli;
+    char* p = out + COORD_WIDTH;
+    for (int i = 0; i < 3; ++i) {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+    }
+    *--p = '.';
+    do {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    if (negative) *--p = '-';
+    while (p > out) *--p = ' ';
+}
+
+// Function to generate random points and write them to a file. Coordinate
+// d of point i is value i * dims + d of the Philox stream keyed by the seed,
+// so the file depends only on n, dims and the seed, not on the thread count.
+bool generate_kmeans_input(long n, int dims, uint64_t seed, int threads) {
+    // Create the filename based on n (and the dimension when it is not 2)
+    string filename = "input_" + to_string(n) + (dims == 2 ? "" : "_d" + to_string(dims)) + ".txt";
+    PositionedFile output_file;
+    string error;
+    if (!output_file.open(filename, error)) {
         cerr << "Error: Unable to create file " << filename << endl;
-        return;
+        return false;
     }
 
-    // Write the number of points as the first line
-    output_file << n << endl;
+    // Write the number of points as the first line, followed by the
+    // dimension when it is not 2
+    string header = to_string(n) + (dims == 2 ? "" : " " + to_string(dims)) + "\n";
+    const size_t point_bytes = (size_t)dims * FIELD_BYTES;
+    if (!output_file.resize((off_t)(header.size() + (size_t)n * point_bytes)) ||
+        !output_file.writeAt(header.data(), header.size(), 0)) {
+        cerr << "Error: Unable to write file " << filename << endl;
+        return false;
+    }
 
-    // Random number generation setup
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_real_distribution<float> dist(-1000.0, 1000.0); // Points between -1000 and 1000
+    // Points between -1000 and 1000, in steps of 0.001
+    const PhiloxKey key = philoxKeyFromSeed(seed);
+    bool written = writeRecords(output_file, (off_t)header.size(), n, point_bytes, POINT_CHUNK, threads,
+                                [&](long begin, long end, char* out) {
+        PhiloxStream stream(key, 0, (uint64_t)begin * (uint64_t)dims);
+        for (long i = begin; i < end; ++i) {
+            for (int d = 0; d < dims; ++d) {
+                int32_t milli = -1000000 + (int32_t)(((uint64_t)stream.next() * 2000000) >> 32);
+                formatCoordinate(out, milli);
+                out[COORD_WIDTH] = (d < dims - 1) ? ' ' : '\n';
+                out += FIELD_BYTES;
+            }
+        }
+    });
 
-    // Generate n random points
-    for (int i = 0; i < n; ++i) {
-        float x = dist(gen);
-        float y = dist(gen);
-        output_file << x << " " << y << endl;
+    if (!written || !output_file.close()) {
+        cerr << "Error: Unable to write file " << filename << endl;
+        return false;
     }
-
-    // Close the file
-    output_file.close();
     cout << "Generated " << n << " points and saved to " << filename << endl;
+    return true;
 }
 
-int main() {
-    int n;
-    cout << "Enter the number of points N: ";
-    cin >> n;
+int main(int argc, char* argv[]) {
+    // Split the --options from the positional arguments
+    vector<string> args;
+    int dims = 2;
+    int threads = max(1, (int)thread::hardware_concurrency());
+    uint64_t seed = random_device()();
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--dims=", 0) == 0) {
+            dims = atoi(arg.substr(7).c_str());
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = atoi(arg.substr(10).c_str());
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = stoull(arg.substr(7));
+        } else {
+            args.push_back(arg);
+        }
+    }
 
+    if (args.size() != 1) {
+        cerr << "Usage: " << argv[0] << " <num_points> [--dims=D] [--seed=N] [--threads=T]" << endl;
+        return 1;
+    }
+    long n = atol(args[0].c_str());
     if (n <= 0) {
         cerr << "Error: The number of points must be greater than 0." << endl;
         return 1;
     }
+    if (dims <= 0 || threads <= 0) {
+        cerr << "Error: The dimension and thread count must be greater than 0." << endl;
+        return 1;
+    }
 
     // Generate input file for K-Means
-    generate_kmeans_input(n);
+    auto start_time = chrono::high_resolution_clock::now();
+    if (!generate_kmeans_input(n, dims, seed, threads)) return 1;
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start_time;
+
+    cout << "Seed: " << seed << endl;
+    cout << "Total time taken: " << elapsed.count() << " seconds" << endl;
 
     return 0;
 }
@@ -1,13 +1,5 @@
 #!/bin/bash
 
-# Debug and configuration flags
-DEBUG=false
-VERBOSE_OUTPUT=false  # Set to true to see more detailed processing information
-
-# Time unit conversion constants
-SECONDS_TO_MICROSECONDS=1000000
-
-
 # run_all_mutithread.sh
 # A comprehensive script to generate inputs, compile C++ and Rust code, run all executables, and collect results.
 
@@ -143,198 +135,6 @@ compile_rust() {
     fi
 }
 
-# Separate run functions for Parallel and Sequential Executables
-
-# C++ Parallel Run Function
-run_cpp_parallel() {
-    PROJECT_DIR=$1
-    EXECUTABLE=$2
-    SIZE=$3
-    THREADS=$4
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_cpp_${EXECUTABLE}_${SIZE}_threads${THREADS}.txt"
-
-    echo_info "Running C++ $EXECUTABLE with size $SIZE and threads $THREADS..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/cpp/$EXECUTABLE $SIZE $THREADS > $output_file"
-    ./"$PROJECT_DIR/cpp/$EXECUTABLE" "$SIZE" "$THREADS" > "$output_file"
-}
-
-# C++ Sequential Run Function
-run_cpp_sequential() {
-    PROJECT_DIR=$1
-    EXECUTABLE=$2
-    SIZE=$3
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_cpp_${EXECUTABLE}_${SIZE}_threads1.txt"
-
-    echo_info "Running C++ $EXECUTABLE with size $SIZE and threads 1..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/cpp/$EXECUTABLE $SIZE > $output_file"
-    ./"$PROJECT_DIR/cpp/$EXECUTABLE" "$SIZE" > "$output_file"
-}
-
-# Rust Parallel Run Function
-run_rust_parallel() {
-    PROJECT_DIR=$1
-    BIN_NAME=$2
-    SIZE=$3
-    THREADS=$4
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_rust_${BIN_NAME}_${SIZE}_threads${THREADS}.txt"
-
-    echo_info "Running Rust $BIN_NAME with size $SIZE and threads $THREADS..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/rust/target/release/$BIN_NAME $SIZE $THREADS > $output_file"
-    ./"$PROJECT_DIR/rust/target/release/$BIN_NAME" "$SIZE" "$THREADS" > "$output_file"
-}
-
-# Rust Sequential Run Function
-run_rust_sequential() {
-    PROJECT_DIR=$1
-    BIN_NAME=$2
-    SIZE=$3
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_rust_${BIN_NAME}_${SIZE}_threads1.txt"
-
-    echo_info "Running Rust $BIN_NAME with size $SIZE and threads 1..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/rust/target/release/$BIN_NAME $SIZE > $output_file"
-    ./"$PROJECT_DIR/rust/target/release/$BIN_NAME" "$SIZE" > "$output_file"
-}
-
-# Run C++ K-Means Parallel
-run_cpp_kmeans_parallel() {
-    PROJECT_DIR=$1
-    EXECUTABLE=$2
-    INPUT_FILE=$3
-    OUTPUT_FILE=$4
-    CLUSTERS=$5
-    THREADS=$6
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_cpp_${EXECUTABLE}_$(basename "$INPUT_FILE" .txt)_threads${THREADS}.txt"
-
-    echo_info "Running C++ $EXECUTABLE with input $INPUT_FILE, clusters $CLUSTERS, and threads $THREADS..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/cpp/$EXECUTABLE $INPUT_FILE $OUTPUT_FILE $CLUSTERS $THREADS > $output_file"
-    ./"$PROJECT_DIR/cpp/$EXECUTABLE" "$INPUT_FILE" "$OUTPUT_FILE" "$CLUSTERS" "$THREADS" > "$output_file"
-}
-
-# Run C++ K-Means Sequential
-run_cpp_kmeans_sequential() {
-    PROJECT_DIR=$1
-    EXECUTABLE=$2
-    INPUT_FILE=$3
-    OUTPUT_FILE=$4
-    CLUSTERS=$5
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_cpp_${EXECUTABLE}_$(basename "$INPUT_FILE" .txt)_threads1.txt"
-
-    echo_info "Running C++ $EXECUTABLE with input $INPUT_FILE, clusters $CLUSTERS, and threads 1..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/cpp/$EXECUTABLE $INPUT_FILE $OUTPUT_FILE $CLUSTERS > $output_file"
-    ./"$PROJECT_DIR/cpp/$EXECUTABLE" "$INPUT_FILE" "$OUTPUT_FILE" "$CLUSTERS" > "$output_file"
-}
-
-# Run Rust K-Means Parallel
-run_rust_kmeans_parallel() {
-    PROJECT_DIR=$1
-    BIN_NAME=$2
-    INPUT_FILE=$3
-    OUTPUT_FILE=$4
-    CLUSTERS=$5
-    THREADS=$6
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_rust_${BIN_NAME}_par_$(basename "$INPUT_FILE" .txt)_threads${THREADS}.txt"
-
-    echo_info "Running Rust $BIN_NAME in parallel mode with input $INPUT_FILE, clusters $CLUSTERS, and threads $THREADS..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/rust/target/release/$BIN_NAME $INPUT_FILE $OUTPUT_FILE $CLUSTERS $THREADS > $output_file"
-    ./"$PROJECT_DIR/rust/target/release/$BIN_NAME" "$INPUT_FILE" "$OUTPUT_FILE" "$CLUSTERS" "$THREADS" > "$output_file"
-}
-
-# Run Rust K-Means Sequential
-run_rust_kmeans_sequential() {
-    PROJECT_DIR=$1
-    BIN_NAME=$2
-    INPUT_FILE=$3
-    OUTPUT_FILE=$4
-    CLUSTERS=$5
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_rust_${BIN_NAME}_seq_$(basename "$INPUT_FILE" .txt)_threads1.txt"
-
-    echo_info "Running Rust $BIN_NAME in sequential mode with input $INPUT_FILE, clusters $CLUSTERS, and threads 1..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/rust/target/release/$BIN_NAME $INPUT_FILE $OUTPUT_FILE $CLUSTERS > $output_file"
-    ./"$PROJECT_DIR/rust/target/release/$BIN_NAME" "$INPUT_FILE" "$OUTPUT_FILE" "$CLUSTERS" > "$output_file"
-}
-
-# Run C++ Matrix Multiplication Parallel
-run_cpp_matrix_parallel() {
-    PROJECT_DIR=$1
-    EXECUTABLE=$2
-    MATRIX1=$3
-    MATRIX2=$4
-    OUTPUT_FILE=$5
-    THREADS=$6
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_cpp_${EXECUTABLE}_$(basename "$MATRIX1")_threads${THREADS}.txt"
-
-    echo_info "Running C++ $EXECUTABLE with matrices $MATRIX1 and $MATRIX2 and threads $THREADS..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/cpp/$EXECUTABLE $MATRIX1 $MATRIX2 $OUTPUT_FILE $THREADS > $output_file"
-    ./"$PROJECT_DIR/cpp/$EXECUTABLE" "$MATRIX1" "$MATRIX2" "$OUTPUT_FILE" "$THREADS" > "$output_file" 2>&1
-}
-
-# Run C++ Matrix Multiplication Sequential
-run_cpp_matrix_sequential() {
-    PROJECT_DIR=$1
-    EXECUTABLE=$2
-    MATRIX1=$3
-    MATRIX2=$4
-    OUTPUT_FILE=$5
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_cpp_${EXECUTABLE}_$(basename "$MATRIX1")_threads1.txt"
-
-    echo_info "Running C++ $EXECUTABLE with matrices $MATRIX1 and $MATRIX2 and threads 1..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/cpp/$EXECUTABLE $MATRIX1 $MATRIX2 $OUTPUT_FILE > $output_file"
-    ./"$PROJECT_DIR/cpp/$EXECUTABLE" "$MATRIX1" "$MATRIX2" "$OUTPUT_FILE" > "$output_file" 2>&1
-}
-
-# Run Rust Matrix Multiplication Parallel
-run_rust_matrix_parallel() {
-    PROJECT_DIR=$1
-    BIN_NAME=$2
-    MATRIX1=$3
-    MATRIX2=$4
-    OUTPUT_FILE=$5
-    THREADS=$6
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_rust_${BIN_NAME}_$(basename "$MATRIX1")_threads${THREADS}.txt"
-
-    echo_info "Running Rust $BIN_NAME with matrices $MATRIX1 and $MATRIX2 and threads $THREADS..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/rust/target/release/$BIN_NAME $MATRIX1 $MATRIX2 $OUTPUT_FILE $THREADS > $output_file"
-    ./"$PROJECT_DIR/rust/target/release/$BIN_NAME" "$MATRIX1" "$MATRIX2" "$OUTPUT_FILE" "$THREADS" > "$output_file" 2>&1
-}
-
-# Run Rust Matrix Multiplication Sequential
-run_rust_matrix_sequential() {
-    PROJECT_DIR=$1
-    BIN_NAME=$2
-    MATRIX1=$3
-    MATRIX2=$4
-    OUTPUT_FILE=$5
-
-    output_file="${RESULTS_DIR}/${PROJECT_DIR}_rust_${BIN_NAME}_$(basename "$MATRIX1")_threads1.txt"
-
-    echo_info "Running Rust $BIN_NAME with matrices $MATRIX1 and $MATRIX2 and threads 1..."
-    # Debug: Show the command being executed
-    echo_info "Command: ./$PROJECT_DIR/rust/target/release/$BIN_NAME $MATRIX1 $MATRIX2 $OUTPUT_FILE > $output_file"
-    ./"$PROJECT_DIR/rust/target/release/$BIN_NAME" "$MATRIX1" "$MATRIX2" "$OUTPUT_FILE" > "$output_file" 2>&1
-}
-
 # Main execution flow
 compile_input_generators
 
@@ -364,319 +164,60 @@ compile_rust "kmeans" "kmeans_rs_seq"
 compile_rust "MonteCarlo" "monte_carlo_par"
 compile_rust "MonteCarlo" "monte_carlo_seq"
 
-# Run experiments with different thread configurations
-for THREADS in "${THREAD_CONFIGS[@]}"; do
-    echo_info "Running experiments with $THREADS threads..."
-
-    # Dijkstra
-    for size in "${Dijkstra_SIZES[@]}"; do
-        # C++ Parallel
-        run_cpp_parallel "Dijkstra" "dijkstra_par" "$size" "$THREADS"
-        # C++ Sequential
-        run_cpp_sequential "Dijkstra" "dijkstra_seq" "$size"
-        # Rust Parallel
-        run_rust_parallel "Dijkstra" "dijkstra_par" "$size" "$THREADS"
-        # Rust Sequential
-        run_rust_sequential "Dijkstra" "dijkstra_seq" "$size"
-    done
-
-    # Monte Carlo
-    for size in "${MC_SIZES[@]}"; do
-        # C++ Parallel
-        run_cpp_parallel "MonteCarlo" "monte_carlo_par" "$size" "$THREADS"
-        # C++ Sequential
-        run_cpp_sequential "MonteCarlo" "monte_carlo_seq" "$size"
-        # Rust Parallel
-        run_rust_parallel "MonteCarlo" "monte_carlo_par" "$size" "$THREADS"
-        # Rust Sequential
-        run_rust_sequential "MonteCarlo" "monte_carlo_seq" "$size"
-    done
-
-    # K-Means
-    for size in "${KMeans_SIZES[@]}"; do
-        input_file="kmeans/input_${size}.txt"
-        output_cpp_par="kmeans/out${size}_omp_par.txt"
-        output_cpp_seq="kmeans/out${size}_cpp_seq.txt"
-        output_rs_par="kmeans/out${size}_rs_par.txt"
-        output_rs_seq="kmeans/out${size}_rs_seq.txt"
-
-        # C++ Parallel
-        run_cpp_kmeans_parallel "kmeans" "kmeans_omp_par" "$input_file" "$output_cpp_par" "$KMEANS_CLUSTERS" "$THREADS"
-        # C++ Sequential
-        run_cpp_kmeans_sequential "kmeans" "kmeans_cpp_seq" "$input_file" "$output_cpp_seq" "$KMEANS_CLUSTERS"
-        # Rust Parallel
-        run_rust_kmeans_parallel "kmeans" "kmeans_rs_par" "$input_file" "$output_rs_par" "$KMEANS_CLUSTERS" "$THREADS"
-        # Rust Sequential
-        run_rust_kmeans_sequential "kmeans" "kmeans_rs_seq" "$input_file" "$output_rs_seq" "$KMEANS_CLUSTERS"
-    done
+# Compile the benchmark driver, which runs and times every configuration
+echo_info "Compiling the benchmark driver..."
+g++ bench/bench_driver.cpp -o bench/bench_driver -std=c++11 -O2
 
-    # Matrix Multiplication
-    for size in "${Matrix_Multiplication_SIZES[@]}"; do
-        # Skip size 10000 for matrix multiplication
-        if [ "$size" -eq 10000 ]; then
-            echo_info "Skipping Matrix Multiplication for size 10000..."
-            continue
-        fi
-        
-        matrix1="Matrix_Multiplication/matrix1_${size}.txt"
-        matrix2="Matrix_Multiplication/matrix2_${size}.txt"
-        output_par="output_${size}_par.txt"
-        output_seq="output_${size}_seq.txt"
-        output_rs_par="output_${size}_rs_par.txt"
-        output_rs_seq="output_${size}_rs_seq.txt"
-
-        # C++ Parallel
-        run_cpp_matrix_parallel "Matrix_Multiplication" "MatrixMultiply_omp_par" "$matrix1" "$matrix2" "$output_par" "$THREADS"
-        # C++ Sequential
-        run_cpp_matrix_sequential "Matrix_Multiplication" "MatrixMultiply_cpp_seq" "$matrix1" "$matrix2" "$output_seq"
-        # Rust Parallel
-        run_rust_matrix_parallel "Matrix_Multiplication" "MatrixMultiply_rs_par" "$matrix1" "$matrix2" "$output_rs_par" "$THREADS"
-        # Rust Sequential
-        run_rust_matrix_sequential "Matrix_Multiplication" "MatrixMultiply_rs_seq" "$matrix1" "$matrix2" "$output_rs_seq"
-    done
-done
+# Untimed warmup runs and timed trials per configuration
+BENCH_WARMUP=${BENCH_WARMUP:-1}
+BENCH_TRIALS=${BENCH_TRIALS:-5}
+BENCH_LOG="${RESULTS_DIR}/bench.log"
 
-# Function to extract time from result files with expanded patterns
-get_file_path() {
+# Function to benchmark one algorithm over its sizes and the thread
+# configurations with bench_driver, writing its table to the results directory
+run_benchmarks() {
     local algorithm=$1
-    local lang=$2
-    local type=$3
-    local size=$4
-    local threads=$5
-    local base_dir="$RESULTS_DIR"
-
-    case "$algorithm" in
-        "Matrix_Multiplication")
-            echo "${base_dir}/${algorithm}_${lang}_${type}_matrix1_${size}.txt_threads${threads}.txt"
-            ;;
-        "kmeans")
-            echo "${base_dir}/${algorithm}_${lang}_${type}_input_${size}_threads${threads}.txt"
-            ;;
-        *)
-            echo "${base_dir}/${algorithm}_${lang}_${type}_${size}_threads${threads}.txt"
-            ;;
-    esac
-}
-
-debug_extraction() {
-    local file=$1
-    local extracted_time=$2
-    if [[ "$DEBUG" == "true" ]]; then
-        echo "Processing file: $file" >&2
-        echo "File contents:" >&2
-        cat "$file" >&2
-        echo "Extracted time: $extracted_time" >&2
-        echo "-------------------" >&2
-    fi
-}
-
-convert_to_microseconds() {
-    local value=$1
-    local unit=$2
-    case "$unit" in
-        "s"|"seconds") echo "$value * 1000000" | bc -l ;;
-        "ms"|"milliseconds") echo "$value * 1000" | bc -l ;;
-        "µs"|"microseconds") echo "$value" | bc -l ;;
-        *) echo "Error: Unknown time unit $unit" >&2; echo "0" ;;
-    esac
-}
-
-convert_scientific_notation() {
-    local value=$1
-    echo "$value" | awk '{printf "%.9f", $1}'
-}
-extract_time() {
-    local file=$1
-    if [[ -f "$file" ]]; then
-        # Read the first (and only) line from the file
-        local time_value
-        read -r time_value < "$file"
-        
-        # Check if the value is a valid number
-        if [[ "$time_value" =~ ^[0-9]+([.][0-9]+)?$ ]]; then
-            # Return the value in microseconds
-            echo "scale=3; $time_value" | bc -l
-        else
-            if [[ "$DEBUG" == "true" ]]; then
-                echo "Invalid time value in file $file: $time_value" >&2
-            fi
-            echo "0"
-        fi
-    else
-        if [[ "$DEBUG" == "true" ]]; then
-            echo "File not found: $file" >&2
-        fi
-        echo "0"
+    local sizes=("${!2}")
+    local size_list
+    local thread_list
+    size_list=$(IFS=,; echo "${sizes[*]}")
+    thread_list=$(IFS=,; echo "${THREAD_CONFIGS[*]}")
+
+    echo_info "Benchmarking $algorithm with sizes $size_list and threads $thread_list..."
+    if ! ./bench/bench_driver --algorithms="$algorithm" --variants=cpp-seq,cpp-par,rust-seq,rust-par \
+            --sizes="$size_list" --threads="$thread_list" --clusters="$KMEANS_CLUSTERS" \
+            --warmup="$BENCH_WARMUP" --trials="$BENCH_TRIALS" \
+            --output="${RESULTS_DIR}/${algorithm}.txt" 2>> "$BENCH_LOG"; then
+        echo_warn "Some $algorithm runs failed; see $BENCH_LOG"
     fi
 }
 
+# Run all executables and collect results
+echo_info "Running all executables with $BENCH_WARMUP warmup runs and $BENCH_TRIALS trials each..."
+run_benchmarks "dijkstra" Dijkstra_SIZES[@]
+run_benchmarks "matrix" Matrix_Multiplication_SIZES[@]
+run_benchmarks "kmeans" KMeans_SIZES[@]
+run_benchmarks "montecarlo" MC_SIZES[@]
 
-
-# Function to get correct result file paths
-get_result_file() {
-    local algorithm=$1
-    local impl_type=$2
-    local size=$3
-    local threads=$4
-    local results_dir=$RESULTS_DIR
-
-    case "$algorithm" in
-        "Matrix_Multiplication")
-            case "$impl_type" in
-                "cpp_seq")
-                    echo "${results_dir}/Matrix_Multiplication_cpp_MatrixMultiply_cpp_seq_matrix1_${size}.txt_threads1.txt"
-                    ;;
-                "cpp_par")
-                    echo "${results_dir}/Matrix_Multiplication_cpp_MatrixMultiply_omp_par_matrix1_${size}.txt_threads${threads}.txt"
-                    ;;
-                "rust_seq")
-                    echo "${results_dir}/Matrix_Multiplication_rust_MatrixMultiply_rs_seq_matrix1_${size}.txt_threads1.txt"
-                    ;;
-                "rust_par")
-                    echo "${results_dir}/Matrix_Multiplication_rust_MatrixMultiply_rs_par_matrix1_${size}.txt_threads${threads}.txt"
-                    ;;
-            esac
-            ;;
-        "kmeans")
-            case "$impl_type" in
-                "cpp_seq")
-                    echo "${results_dir}/kmeans_cpp_kmeans_cpp_seq_input_${size}_threads1.txt"
-                    ;;
-                "cpp_par")
-                    echo "${results_dir}/kmeans_cpp_kmeans_omp_par_input_${size}_threads${threads}.txt"
-                    ;;
-                "rust_seq")
-                    echo "${results_dir}/kmeans_rust_kmeans_rs_seq_seq_input_${size}_threads1.txt"
-                    ;;
-                "rust_par")
-                    echo "${results_dir}/kmeans_rust_kmeans_rs_par_par_input_${size}_threads${threads}.txt"
-                    ;;
-            esac
-            ;;
-        "Dijkstra")
-            case "$impl_type" in
-                "cpp_seq")
-                    echo "${results_dir}/Dijkstra_cpp_dijkstra_seq_${size}_threads1.txt"
-                    ;;
-                "cpp_par")
-                    echo "${results_dir}/Dijkstra_cpp_dijkstra_par_${size}_threads${threads}.txt"
-                    ;;
-                "rust_seq")
-                    echo "${results_dir}/Dijkstra_rust_dijkstra_seq_${size}_threads1.txt"
-                    ;;
-                "rust_par")
-                    echo "${results_dir}/Dijkstra_rust_dijkstra_par_${size}_threads${threads}.txt"
-                    ;;
-            esac
-            ;;
-        "MonteCarlo")
-            case "$impl_type" in
-                "cpp_seq")
-                    echo "${results_dir}/MonteCarlo_cpp_monte_carlo_seq_${size}_threads1.txt"
-                    ;;
-                "cpp_par")
-                    echo "${results_dir}/MonteCarlo_cpp_monte_carlo_par_${size}_threads${threads}.txt"
-                    ;;
-                "rust_seq")
-                    echo "${results_dir}/MonteCarlo_rust_monte_carlo_seq_${size}_threads1.txt"
-                    ;;
-                "rust_par")
-                    echo "${results_dir}/MonteCarlo_rust_monte_carlo_par_${size}_threads${threads}.txt"
-                    ;;
-            esac
-            ;;
-    esac
-}
-
-# Updated function to print results table
-print_algorithm_section() {
-    local title=$1
-    local sizes=("${!2}")
-    local algorithm=$3
-
-    echo "$title"
-    echo "----------------------------------------"
-
-    for size in "${sizes[@]}"; do
-        echo "Problem Size: $size"
-        echo "Threads | C++ Seq (ms) | C++ Par (ms) | Rust Seq (ms) | Rust Par (ms) | C++ Speedup | Rust Speedup"
-        echo "--------|--------------|--------------|---------------|---------------|-------------|-------------"
-
-        # Get sequential times
-        local cpp_seq_file=$(get_result_file "$algorithm" "cpp_seq" "$size" "1")
-        local rust_seq_file=$(get_result_file "$algorithm" "rust_seq" "$size" "1")
-        
-        local cpp_seq_time=$(extract_time "$cpp_seq_file")
-        local rust_seq_time=$(extract_time "$rust_seq_file")
-
-        if [[ "$DEBUG" == "true" ]]; then
-            echo "Sequential file paths:"
-            echo "C++: $cpp_seq_file"
-            echo "Rust: $rust_seq_file"
-            echo "Times extracted:"
-            echo "C++ Sequential: $cpp_seq_time"
-            echo "Rust Sequential: $rust_seq_time"
-        fi
-
-        # For each thread configuration
-        for threads in "${THREAD_CONFIGS[@]}"; do
-            local cpp_par_file=$(get_result_file "$algorithm" "cpp_par" "$size" "$threads")
-            local rust_par_file=$(get_result_file "$algorithm" "rust_par" "$size" "$threads")
-            
-            local cpp_par_time=$(extract_time "$cpp_par_file")
-            local rust_par_time=$(extract_time "$rust_par_file")
-
-            if [[ "$DEBUG" == "true" ]]; then
-                echo "Thread $threads parallel file paths:"
-                echo "C++: $cpp_par_file"
-                echo "Rust: $rust_par_file"
-                echo "Times extracted:"
-                echo "C++ Parallel: $cpp_par_time"
-                echo "Rust Parallel: $rust_par_time"
-            fi
-
-            # Calculate speedups
-            local cpp_speedup=$(calculate_speedup "$cpp_seq_time" "$cpp_par_time")
-            local rust_speedup=$(calculate_speedup "$rust_seq_time" "$rust_par_time")
-
-            printf "%-8s | %12.3f | %12.3f | %13.3f | %13.3f | %11.2f | %11.2f\n" \
-                "$threads" "$cpp_seq_time" "$cpp_par_time" "$rust_seq_time" "$rust_par_time" "$cpp_speedup" "$rust_speedup"
-        done
-        echo ""
-    done
-    echo ""
-}
-
-# Helper function to calculate speedup
-calculate_speedup() {
-    local seq_time=$1
-    local par_time=$2
-    
-    if [[ -n "$seq_time" && -n "$par_time" && "$par_time" != "0" && "$seq_time" != "0" ]]; then
-        # Use bc for floating point arithmetic with high precision
-        printf "%.2f" $(echo "scale=6; $seq_time/$par_time" | bc -l)
-    else
-        echo "0.00"
-    fi
-}
-# Create performance comparison report
-PERFORMANCE_FILE="${RESULTS_DIR}/performance_comparison_threads.txt"
+echo_info "Creating results summary..."
+PERFORMANCE_FILE="${RESULTS_DIR}/performance_comparison.txt"
 {
     echo "Performance Comparison: Rust vs C++ with Multiple Thread Configurations"
     echo "=================================================================="
     echo "Date: $(date)"
     echo ""
-
-    print_algorithm_section "1. Dijkstra's Algorithm" Dijkstra_SIZES[@] "Dijkstra"
-    print_algorithm_section "2. Matrix Multiplication" Matrix_Multiplication_SIZES[@] "Matrix_Multiplication"
-    print_algorithm_section "3. K-Means Clustering" KMeans_SIZES[@] "kmeans"
-    print_algorithm_section "4. Monte Carlo" MC_SIZES[@] "MonteCarlo"
+    for section in "1. Dijkstra's Algorithm:dijkstra" "2. Matrix Multiplication:matrix" \
+                   "3. K-Means Clustering:kmeans" "4. Monte Carlo:montecarlo"; do
+        echo "${section%%:*}"
+        echo "----------------------------------------"
+        cat "${RESULTS_DIR}/${section##*:}.txt" 2>/dev/null || echo "(no results)"
+        echo ""
+    done
 
     echo "Notes:"
-    echo "- All times are in microseconds (ms)"
-    echo "- Speedup = Sequential Time / Parallel Time"
+    echo "- All times are in microseconds (µs), over $BENCH_TRIALS trials after $BENCH_WARMUP warmup runs"
+    echo "- Speedup = median sequential time / median parallel time, per language"
     echo "- Tests conducted with thread counts: ${THREAD_CONFIGS[*]}"
-    echo "- Sequential times are shown for reference and are the same across all thread configurations"
 } > "$PERFORMANCE_FILE"
 
 echo_info "Performance comparison has been written to: $PERFORMANCE_FILE"
@@ -0,0 +1,758 @@
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../api/kernels.h"
+#include "../common/bench.h"
+
+// Long-running job server for the kernels.
+//
+// Graphs, matrices and K-means point sets are loaded once and stay resident.
+// Requests arrive as text lines on stdin (responses on stdout) or over a Unix
+// domain socket. A dispatcher takes requests off the queue in batches, groups
+// the ones that hit the same kernel and dataset, and hands each group to a
+// worker. Workers are started once and each owns its kernel contexts, so
+// buffers and OpenMP teams stay warm between requests.
+//
+// Usage:
+//   kernel_server [--socket=PATH] [--workers=W] [--threads=T]
+//                 [--batch=32] [--batch-wait-us=200]
+//
+// Protocol (one request per line, fields separated by spaces; every response
+// line starts with the request id, then "ok" or "error"):
+//   load ID graph|matrix|points NAME PATH     load a dataset from a file
+//   generate ID graph NAME VERTICES SEED      create a random graph
+//   sssp ID GRAPH SOURCE [TARGET]             shortest paths from SOURCE
+//   multiply ID A B [OUTPUT_PATH]             C = A * B
+//   kmeans ID POINTS K [MAX_ITERATIONS]       cluster a point set
+//   pi ID SAMPLES SEED                        Monte Carlo estimate of pi
+//   stats ID                                  latency percentiles per kind
+//   quit                                      stdin: drain and exit
+//   shutdown                                  socket: drain and exit
+//
+// Latency is measured from the moment a request is read to the moment its
+// response is written, so it includes queueing and batching delay.
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+struct ServerConfig {
+    string socket_path;           // Empty means stdin / stdout
+    int workers = 1;              // Worker threads running kernels
+    int threads = 0;              // OpenMP threads per worker, 0 for default
+    size_t batch = 32;            // Most requests taken off the queue at once
+    long batch_wait_us = 200;     // How long to wait for a batch to fill up
+};
+
+// Where responses for one connection go
+struct Client {
+    int out_fd;
+    bool owns_fd;
+    mutex write_lock;
+
+    Client(int fd, bool owns) : out_fd(fd), owns_fd(owns) {}
+    ~Client() {
+        if (owns_fd) close(out_fd);
+    }
+
+    // Function to write one response line
+    void send(const string& line) {
+        string data = line + "\n";
+        lock_guard<mutex> guard(write_lock);
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(out_fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;   // Client went away; drop the response
+            written += n;
+        }
+    }
+};
+
+struct Request {
+    string command;
+    string id;
+    vector<string> args;
+    shared_ptr<Client> client;
+    Clock::time_point received;
+    mutable bool answered = false;   // Set by respond()
+};
+
+// Queue between the connection readers and the dispatcher
+class RequestQueue {
+public:
+    void push(Request request) {
+        {
+            lock_guard<mutex> guard(lock_);
+            queue_.push_back(std::move(request));
+        }
+        ready_.notify_one();
+    }
+
+    void close() {
+        {
+            lock_guard<mutex> guard(lock_);
+            closed_ = true;
+        }
+        ready_.notify_all();
+    }
+
+    // Function to wait for at least one request, then keep collecting for up
+    // to wait_us or until max requests are queued. Returns an empty batch
+    // once the queue is closed and drained.
+    vector<Request> popBatch(size_t max, long wait_us) {
+        unique_lock<mutex> lock(lock_);
+        ready_.wait(lock, [this]() { return closed_ || !queue_.empty(); });
+        if (!closed_ && queue_.size() < max && wait_us > 0) {
+            ready_.wait_for(lock, chrono::microseconds(wait_us),
+                            [this, max]() { return closed_ || queue_.size() >= max; });
+        }
+
+        vector<Request> batch;
+        while (!queue_.empty() && batch.size() < max) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        return batch;
+    }
+
+private:
+    mutex lock_;
+    condition_variable ready_;
+    deque<Request> queue_;
+    bool closed_ = false;
+};
+
+// Point set for the kmeans requests: n points of dims coordinates each
+struct PointSet {
+    vector<float> coords;
+    int dims = 2;
+};
+
+// Resident datasets. Requests hold shared pointers, so replacing a dataset
+// never disturbs a request already bound to the old one.
+struct Datasets {
+    map<string, shared_ptr<const Graph>> graphs;
+    map<string, shared_ptr<const Matrix>> matrices;
+    map<string, shared_ptr<const PointSet>> points;
+};
+
+// Per-worker kernel contexts, kept across requests
+struct WorkerContext {
+    ShortestPath sssp;
+    MatrixMultiplier gemm;
+    KMeans kmeans;
+    MonteCarlo monte_carlo;
+    // Point set loaded into kmeans; holding it keeps its address from being reused
+    shared_ptr<const PointSet> kmeans_points;
+
+    explicit WorkerContext(int threads)
+        : sssp(threads), gemm(threads), kmeans(threads), monte_carlo(threads) {}
+};
+
+// Fixed set of worker threads, each with its own contexts
+class WorkerPool {
+public:
+    typedef function<void(WorkerContext&)> Task;
+
+    WorkerPool(int workers, int threads) {
+        for (int i = 0; i < workers; i++) {
+            threads_.emplace_back([this, threads]() { workerLoop(threads); });
+        }
+    }
+
+    // Function to finish every queued task and stop the workers
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> guard(lock_);
+            stop_ = true;
+        }
+        ready_.notify_all();
+        for (thread& t : threads_) t.join();
+    }
+
+    void submit(Task task) {
+        {
+            lock_guard<mutex> guard(lock_);
+            tasks_.push_back(std::move(task));
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void workerLoop(int threads) {
+        WorkerContext context(threads);
+        while (true) {
+            Task task;
+            {
+                unique_lock<mutex> lock(lock_);
+                ready_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task(context);
+        }
+    }
+
+    mutex lock_;
+    condition_variable ready_;
+    deque<Task> tasks_;
+    bool stop_ = false;
+    vector<thread> threads_;
+};
+
+// Per-kind latency samples (most recent LATENCY_WINDOW) and batch counters
+#define LATENCY_WINDOW 65536
+
+class LatencyStats {
+public:
+    void record(const string& kind, double micros) {
+        lock_guard<mutex> guard(lock_);
+        Window& w = windows_[kind];
+        if (w.samples.size() < LATENCY_WINDOW) {
+            w.samples.push_back(micros);
+        } else {
+            w.samples[w.next] = micros;
+            w.next = (w.next + 1) % LATENCY_WINDOW;
+        }
+        w.total++;
+    }
+
+    void recordBatch(size_t requests, size_t groups) {
+        lock_guard<mutex> guard(lock_);
+        batches_++;
+        batched_requests_ += requests;
+        batch_groups_ += groups;
+    }
+
+    // Function to format one line per request kind
+    vector<string> report() {
+        lock_guard<mutex> guard(lock_);
+        vector<string> lines;
+        for (auto& entry : windows_) {
+            vector<double> sorted = entry.second.samples;
+            sort(sorted.begin(), sorted.end());
+            ostringstream line;
+            line << fixed << setprecision(1) << entry.first << " count=" << entry.second.total
+                 << " p50_us=" << quantile(sorted, 0.5) << " p95_us=" << quantile(sorted, 0.95)
+                 << " p99_us=" << quantile(sorted, 0.99) << " max_us=" << (sorted.empty() ? 0.0 : sorted.back());
+            lines.push_back(line.str());
+        }
+        ostringstream line;
+        line << fixed << setprecision(2) << "batches=" << batches_ << " requests_per_batch="
+             << (batches_ ? (double)batched_requests_ / batches_ : 0.0) << " groups_per_batch="
+             << (batches_ ? (double)batch_groups_ / batches_ : 0.0);
+        lines.push_back(line.str());
+        return lines;
+    }
+
+private:
+    struct Window {
+        vector<double> samples;
+        size_t next = 0;
+        long total = 0;
+    };
+
+    mutex lock_;
+    map<string, Window> windows_;
+    long batches_ = 0;
+    long batched_requests_ = 0;
+    long batch_groups_ = 0;
+};
+
+static LatencyStats latency;
+
+// Function to send a response and record the request's latency
+void respond(const Request& request, const string& status) {
+    request.answered = true;
+    request.client->send(request.id + " " + status);
+    double micros = chrono::duration<double, micro>(Clock::now() - request.received).count();
+    latency.record(request.command, micros);
+}
+
+// Function to parse a non-negative integer field
+bool parseLong(const string& text, long& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = strtol(text.c_str(), &end, 10);
+    return errno == 0 && end != text.c_str() && *end == '\0' && value >= 0;
+}
+
+// Function to run the shortest path requests of one group
+void runShortestPaths(WorkerContext& context, const Graph& graph, const vector<Request>& requests) {
+    for (const Request& r : requests) {
+        long source = 0, target = -1;
+        if (!parseLong(r.args[1], source) || source >= graph.vertices() ||
+            (r.args.size() > 2 && (!parseLong(r.args[2], target) || target >= graph.vertices()))) {
+            respond(r, "error invalid vertex");
+            continue;
+        }
+
+        const vector<ShortestPath::Distance>& dist = context.sssp.run(graph, source);
+        ostringstream out;
+        if (target >= 0) {
+            if (dist[target] == ShortestPath::kUnreachable) out << "ok distance=unreachable";
+            else out << "ok distance=" << dist[target];
+        } else {
+            long long checksum = 0;
+            long reachable = 0;
+            for (ShortestPath::Distance d : dist) {
+                if (d == ShortestPath::kUnreachable) continue;
+                checksum += d;
+                reachable++;
+            }
+            out << "ok reachable=" << reachable << " checksum=" << checksum;
+        }
+        respond(r, out.str());
+    }
+}
+
+// Function to run the multiply requests of one group
+void runMultiplies(WorkerContext& context, const vector<shared_ptr<const Matrix>>& operands,
+                   const vector<Request>& requests) {
+    Matrix C;   // Reused across the group
+    for (size_t i = 0; i < requests.size(); i++) {
+        const Request& r = requests[i];
+        const Matrix& A = *operands[2 * i];
+        const Matrix& B = *operands[2 * i + 1];
+        string error;
+        if (!context.gemm.multiply(A, B, C, error)) {
+            respond(r, "error " + error);
+            continue;
+        }
+        if (r.args.size() > 2 && !C.save(r.args[2], error)) {
+            respond(r, "error " + error);
+            continue;
+        }
+
+        long long checksum = 0;
+        for (int row = 0; row < C.rows(); row++) {
+            for (int col = 0; col < C.cols(); col++) checksum += C.at(row, col);
+        }
+        respond(r, "ok rows=" + to_string(C.rows()) + " cols=" + to_string(C.cols()) +
+                   " checksum=" + to_string(checksum));
+    }
+}
+
+// Function to run the clustering requests of one group
+void runKMeans(WorkerContext& context, const shared_ptr<const PointSet>& points,
+               const vector<Request>& requests) {
+    // The worker's KMeans context keeps the last point set; only copy a new one
+    if (context.kmeans_points != points) {
+        const long n = (long)points->coords.size() / points->dims;
+        context.kmeans.setPoints(points->coords.data(), n, points->dims);
+        context.kmeans_points = points;
+    }
+
+    for (const Request& r : requests) {
+        long k = 0, max_iterations = 0;
+        if (!parseLong(r.args[1], k) || k == 0 || (r.args.size() > 2 && !parseLong(r.args[2], max_iterations))) {
+            respond(r, "error invalid cluster count or iteration limit");
+            continue;
+        }
+        int iterations = context.kmeans.run((int)k, (int)max_iterations);
+        if (iterations < 0) {
+            respond(r, "error fewer points than clusters");
+            continue;
+        }
+
+        ostringstream out;
+        out << "ok iterations=" << iterations << " centroids=";
+        const float* centroids = context.kmeans.centroids();
+        const int dims = context.kmeans.dims();
+        for (long j = 0; j < k; j++) {
+            for (int d = 0; d < dims; d++) {
+                out << (d ? "," : j ? ";" : "") << centroids[j * dims + d];
+            }
+        }
+        respond(r, out.str());
+    }
+}
+
+// Function to run the pi requests of one group
+void runMonteCarlo(WorkerContext& context, const vector<Request>& requests) {
+    for (const Request& r : requests) {
+        long samples = 0, seed = 0;
+        if (!parseLong(r.args[0], samples) || samples == 0 || !parseLong(r.args[1], seed)) {
+            respond(r, "error invalid sample count or seed");
+            continue;
+        }
+        ostringstream out;
+        out << setprecision(17) << "ok estimate=" << context.monte_carlo.estimatePi(samples, (uint64_t)seed);
+        respond(r, out.str());
+    }
+}
+
+// Function to execute a load or generate request on the dispatcher thread,
+// so that later requests in the stream see the new dataset
+void runLoad(Datasets& data, const Request& r) {
+    const string& type = r.args[0];
+    const string& name = r.args[1];
+    string error;
+
+    if (r.command == "generate") {
+        long vertices = 0, seed = 0;
+        if (type != "graph" || r.args.size() != 4 || !parseLong(r.args[2], vertices) || vertices == 0 ||
+            !parseLong(r.args[3], seed)) {
+            respond(r, "error usage: generate ID graph NAME VERTICES SEED");
+            return;
+        }
+        data.graphs[name] = make_shared<const Graph>(Graph::random(vertices, (unsigned int)seed));
+        respond(r, "ok vertices=" + to_string(vertices));
+        return;
+    }
+
+    if (r.args.size() != 3) {
+        respond(r, "error usage: load ID graph|matrix|points NAME PATH");
+        return;
+    }
+    const string& path = r.args[2];
+
+    if (type == "graph") {
+        shared_ptr<Graph> graph = make_shared<Graph>();
+        if (!graph->load(path, error)) return respond(r, "error " + error);
+        data.graphs[name] = graph;
+        respond(r, "ok vertices=" + to_string(graph->vertices()));
+    } else if (type == "matrix") {
+        shared_ptr<Matrix> matrix = make_shared<Matrix>();
+        if (!matrix->load(path, error)) return respond(r, "error " + error);
+        data.matrices[name] = matrix;
+        respond(r, "ok rows=" + to_string(matrix->rows()) + " cols=" + to_string(matrix->cols()));
+    } else if (type == "points") {
+        KMeans loader(1);
+        if (!loader.load(path, error)) return respond(r, "error " + error);
+        shared_ptr<PointSet> points = make_shared<PointSet>();
+        points->coords = loader.points();
+        points->dims = loader.dims();
+        data.points[name] = points;
+        respond(r, "ok points=" + to_string(loader.numPoints()) + " dims=" + to_string(loader.dims()));
+    } else {
+        respond(r, "error unknown dataset type " + type);
+    }
+}
+
+// Requests of one batch that share a kernel and dataset, run back to back on
+// one worker
+struct Group {
+    string kind;
+    shared_ptr<const Graph> graph;
+    shared_ptr<const PointSet> points;
+    vector<shared_ptr<const Matrix>> operands;   // A, B per multiply request
+    vector<Request> requests;
+};
+
+// Function to look up a dataset, answering the request if it is missing
+template <class T>
+shared_ptr<const T> findDataset(const map<string, shared_ptr<const T>>& datasets, const string& name,
+                                const Request& r) {
+    auto it = datasets.find(name);
+    if (it == datasets.end()) {
+        respond(r, "error unknown dataset " + name);
+        return nullptr;
+    }
+    return it->second;
+}
+
+// Function to pull batches off the queue, group them and hand the groups to
+// the workers, until the queue is closed and drained
+void dispatch(const ServerConfig& config, RequestQueue& queue, WorkerPool& pool) {
+    Datasets data;
+
+    while (true) {
+        vector<Request> batch = queue.popBatch(config.batch, config.batch_wait_us);
+        if (batch.empty()) break;
+
+        vector<shared_ptr<Group>> groups;
+        map<string, shared_ptr<Group>> by_key;
+        for (Request& r : batch) {
+            if (r.command == "load" || r.command == "generate") {
+                // A dataset too large to allocate fails this request only
+                try {
+                    runLoad(data, r);
+                } catch (const exception& e) {
+                    respond(r, string("error ") + e.what());
+                }
+                continue;
+            }
+            if (r.command == "stats") {
+                for (const string& line : latency.report()) r.client->send(r.id + " stats " + line);
+                respond(r, "ok");
+                continue;
+            }
+
+            // Requests are bound to the dataset as it is now, so a later load
+            // under the same name does not affect them
+            ostringstream key;
+            shared_ptr<const Graph> graph;
+            shared_ptr<const PointSet> points;
+            shared_ptr<const Matrix> a, b;
+            if (r.command == "sssp") {
+                if (!(graph = findDataset(data.graphs, r.args[0], r))) continue;
+                key << "sssp " << graph.get();
+            } else if (r.command == "multiply") {
+                if (!(a = findDataset(data.matrices, r.args[0], r))) continue;
+                if (!(b = findDataset(data.matrices, r.args[1], r))) continue;
+                key << "multiply " << a.get();
+            } else if (r.command == "kmeans") {
+                if (!(points = findDataset(data.points, r.args[0], r))) continue;
+                key << "kmeans " << points.get();
+            } else {
+                key << "pi";
+            }
+
+            shared_ptr<Group>& group = by_key[key.str()];
+            if (!group) {
+                group = make_shared<Group>();
+                group->kind = r.command;
+                group->graph = graph;
+                group->points = points;
+                groups.push_back(group);
+            }
+            if (a) {
+                group->operands.push_back(a);
+                group->operands.push_back(b);
+            }
+            group->requests.push_back(std::move(r));
+        }
+        latency.recordBatch(batch.size(), groups.size());
+
+        for (const shared_ptr<Group>& group : groups) {
+            pool.submit([group](WorkerContext& context) {
+                // A kernel that throws (e.g. bad_alloc) fails the requests of
+                // its group that have no response yet, not the server
+                try {
+                    if (group->kind == "sssp") runShortestPaths(context, *group->graph, group->requests);
+                    else if (group->kind == "multiply") runMultiplies(context, group->operands, group->requests);
+                    else if (group->kind == "kmeans") runKMeans(context, group->points, group->requests);
+                    else runMonteCarlo(context, group->requests);
+                } catch (const exception& e) {
+                    for (const Request& r : group->requests) {
+                        if (!r.answered) respond(r, string("error ") + e.what());
+                    }
+                }
+            });
+        }
+    }
+}
+
+// Function to check that a command is known and has enough arguments
+bool checkArguments(const string& command, size_t count, string& error) {
+    static const map<string, pair<size_t, size_t>> arity = {
+        {"load", {3, 3}}, {"generate", {4, 4}}, {"sssp", {2, 3}}, {"multiply", {2, 3}},
+        {"kmeans", {2, 3}}, {"pi", {2, 2}}, {"stats", {0, 0}},
+    };
+    auto it = arity.find(command);
+    if (it == arity.end()) {
+        error = "unknown command " + command;
+        return false;
+    }
+    if (count < it->second.first || count > it->second.second) {
+        error = "wrong number of arguments for " + command;
+        return false;
+    }
+    return true;
+}
+
+// Function to parse one request line and queue it. Returns false when the
+// line asks the connection (quit) or the server (shutdown) to stop.
+bool handleLine(string line, const shared_ptr<Client>& client, RequestQueue& queue, bool& shutdown_requested) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    istringstream fields(line);
+    Request request;
+    if (!(fields >> request.command) || request.command[0] == '#') return true;
+    if (request.command == "quit") return false;
+    if (request.command == "shutdown") {
+        shutdown_requested = true;
+        return false;
+    }
+
+    request.received = Clock::now();
+    request.client = client;
+    if (!(fields >> request.id)) {
+        client->send("- error missing request id");
+        return true;
+    }
+    string arg, error;
+    while (fields >> arg) request.args.push_back(arg);
+    if (!checkArguments(request.command, request.args.size(), error)) {
+        client->send(request.id + " error " + error);
+        return true;
+    }
+
+    queue.push(std::move(request));
+    return true;
+}
+
+// Function to read request lines from a descriptor until EOF, quit or
+// shutdown. Returns whether shutdown was requested.
+bool serveConnection(int in_fd, const shared_ptr<Client>& client, RequestQueue& queue) {
+    string buffer;
+    char chunk[4096];
+    bool shutdown_requested = false;
+
+    while (true) {
+        size_t newline;
+        while ((newline = buffer.find('\n')) != string::npos) {
+            string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!handleLine(line, client, queue, shutdown_requested)) return shutdown_requested;
+        }
+
+        ssize_t n = read(in_fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        buffer.append(chunk, n);
+    }
+
+    if (!buffer.empty()) handleLine(buffer, client, queue, shutdown_requested);
+    return shutdown_requested;
+}
+
+// Function to accept connections on a Unix domain socket until a client
+// sends shutdown
+int serveSocket(const ServerConfig& config, RequestQueue& queue) {
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        cerr << "Error: socket: " << strerror(errno) << endl;
+        return 1;
+    }
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (config.socket_path.size() >= sizeof(addr.sun_path)) {
+        cerr << "Error: Socket path too long: " << config.socket_path << endl;
+        close(listen_fd);
+        return 1;
+    }
+    strncpy(addr.sun_path, config.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(config.socket_path.c_str());
+    if (bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 64) != 0) {
+        cerr << "Error: Unable to listen on " << config.socket_path << ": " << strerror(errno) << endl;
+        close(listen_fd);
+        return 1;
+    }
+    cerr << "Listening on " << config.socket_path << endl;
+
+    // One reader thread per open connection, by descriptor. A reader that
+    // exits moves its own thread to finished, which the accept loop joins,
+    // so a long-running server holds no thread per closed connection.
+    mutex connections_lock;
+    condition_variable reader_exited;
+    map<int, thread> readers;
+    vector<thread> finished;
+
+    auto joinFinished = [&]() {
+        vector<thread> done;
+        {
+            lock_guard<mutex> guard(connections_lock);
+            done.swap(finished);
+        }
+        for (thread& t : done) t.join();
+    };
+
+    while (true) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;   // Listening socket shut down
+        }
+        joinFinished();
+
+        lock_guard<mutex> guard(connections_lock);
+        readers[fd] = thread([fd, listen_fd, &queue, &connections_lock, &reader_exited, &readers, &finished]() {
+            shared_ptr<Client> client = make_shared<Client>(fd, true);
+            if (serveConnection(fd, client, queue)) shutdown(listen_fd, SHUT_RDWR);
+
+            // Deregister while client still holds the descriptor open, so it
+            // cannot be reused by a new connection before the entry is gone
+            lock_guard<mutex> guard(connections_lock);
+            auto self = readers.find(fd);
+            finished.push_back(std::move(self->second));
+            readers.erase(self);
+            reader_exited.notify_all();
+        });
+    }
+
+    // Stop reading from the remaining clients; their sockets stay writable so
+    // queued requests still get their responses
+    {
+        unique_lock<mutex> lock(connections_lock);
+        for (auto& reader : readers) shutdown(reader.first, SHUT_RD);
+        reader_exited.wait(lock, [&readers]() { return readers.empty(); });
+    }
+    joinFinished();
+    close(listen_fd);
+    unlink(config.socket_path.c_str());
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string value = (eq == string::npos) ? "" : arg.substr(eq + 1);
+
+        if (key == "--socket") config.socket_path = value;
+        else if (key == "--workers") config.workers = stoi(value);
+        else if (key == "--threads") config.threads = stoi(value);
+        else if (key == "--batch") config.batch = stoul(value);
+        else if (key == "--batch-wait-us") config.batch_wait_us = stol(value);
+        else {
+            cerr << "Usage: " << argv[0] << " [--socket=PATH] [--workers=W] [--threads=T]"
+                 << " [--batch=N] [--batch-wait-us=US]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (config.workers <= 0 || config.threads < 0 || config.batch == 0 || config.batch_wait_us < 0) {
+        cerr << "Error: workers and batch must be positive, threads and batch wait non-negative." << endl;
+        return EXIT_FAILURE;
+    }
+
+    // A client that disconnects early must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    int status = 0;
+    {
+        RequestQueue queue;
+        WorkerPool pool(config.workers, config.threads);
+        thread dispatcher([&config, &queue, &pool]() { dispatch(config, queue, pool); });
+
+        if (config.socket_path.empty()) {
+            serveConnection(STDIN_FILENO, make_shared<Client>(STDOUT_FILENO, false), queue);
+        } else {
+            status = serveSocket(config, queue);
+        }
+
+        // Drain: the dispatcher hands out what is queued, then the pool's
+        // destructor waits for the workers to finish it
+        queue.close();
+        dispatcher.join();
+    }
+
+    cerr << "Request latency (us, includes queueing and batching):" << endl;
+    for (const string& line : latency.report()) cerr << "  " << line << endl;
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
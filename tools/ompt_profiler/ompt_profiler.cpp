@@ -0,0 +1,267 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <mutex>
+#include <vector>
+#include <omp-tools.h>
+
+// OMPT tool that measures OpenMP runtime overhead against useful work, per
+// thread, for any OpenMP binary in the repo.
+//
+// The runtime calls back into the tool at parallel region begin/end, implicit
+// task begin/end, barrier and taskwait waits, critical section and lock
+// acquisition, worksharing loop begin/end, chunk dispatch and task creation.
+// Each thread accumulates its own counters (no shared writes on the hot
+// path); the report is printed when the runtime shuts down.
+//
+// Per thread:
+//   task      time inside implicit tasks (parallel region bodies)
+//   fork      delay from parallel-begin on the master to the thread's task start
+//   barrier   time waiting in implicit / explicit barriers, taskwait, taskgroup
+//   lock      time waiting to enter critical sections and locks
+//   loop      time inside worksharing loops the runtime dispatches
+//   useful    task - barrier - lock
+//
+// GCC expands schedule(static) loops inline without calling the runtime, so
+// those loops show up as task time but not as loops or chunks.
+//
+// Compilation Instructions:
+// g++ -O2 -std=c++11 -fPIC -shared -I<dir with omp-tools.h> -o libompt_profiler.so ompt_profiler.cpp
+//
+// Usage (OMPT needs the LLVM OpenMP runtime; libgomp has no tool interface,
+// but libomp implements the GOMP entry points g++ binaries call):
+// LD_PRELOAD=/usr/lib/llvm-14/lib/libomp.so OMP_TOOL_LIBRARIES=./libompt_profiler.so ./kmeans_omp_par ...
+//
+// Set OMPT_PROFILER_OUTPUT=FILE to write the report to a file instead of stderr.
+
+// Counters owned by one thread. Each is a separate heap allocation ending in
+// a cache line of padding, so the fields it writes are at least 64 bytes
+// from those of any other thread and never share a cache line with them.
+// (The struct is not cache-line aligned: C++11 new ignores alignas(64).)
+struct ThreadStats {
+    int index = 0;                 // Registration order
+    int type = 0;                  // ompt_thread_t
+    uint64_t implicit_tasks = 0;
+    uint64_t task_ns = 0;
+    uint64_t fork_ns = 0;
+    uint64_t join_ns = 0;          // Master only: last task end to parallel end
+    uint64_t regions = 0;          // Parallel regions started by this thread
+    uint64_t barrier_ns = 0;
+    uint64_t barriers = 0;
+    uint64_t lock_ns = 0;
+    uint64_t locks = 0;
+    uint64_t loops = 0;
+    uint64_t loop_ns = 0;
+    uint64_t chunks = 0;
+    uint64_t tasks_created = 0;
+
+    uint64_t task_begin = 0;
+    uint64_t task_end = 0;
+    uint64_t wait_begin = 0;
+    uint64_t lock_begin = 0;
+    uint64_t loop_begin = 0;
+    char padding[64];
+};
+
+static ompt_get_thread_data_t get_thread_data = nullptr;
+// The runtime finalizes the tool after static destructors have run, so the
+// registry is allocated once and never freed
+static std::mutex& registry_lock = *new std::mutex();
+static std::vector<ThreadStats*>& registry = *new std::vector<ThreadStats*>();
+static uint64_t start_ns = 0;
+static bool dispatch_supported = false;
+
+// Function to read the monotonic clock in nanoseconds
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// Function to get the calling thread's counters, creating them on first use
+static ThreadStats* threadStats() {
+    ompt_data_t* data = get_thread_data();
+    if (data->ptr != nullptr) return static_cast<ThreadStats*>(data->ptr);
+
+    ThreadStats* stats = new ThreadStats();
+    std::lock_guard<std::mutex> guard(registry_lock);
+    stats->index = static_cast<int>(registry.size());
+    registry.push_back(stats);
+    data->ptr = stats;
+    return stats;
+}
+
+static void onThreadBegin(ompt_thread_t thread_type, ompt_data_t* thread_data) {
+    thread_data->ptr = nullptr;
+    threadStats()->type = thread_type;
+}
+
+static void onParallelBegin(ompt_data_t*, const ompt_frame_t*, ompt_data_t* parallel_data,
+                            unsigned int, int, const void*) {
+    parallel_data->value = nowNs();
+    threadStats()->regions++;
+}
+
+static void onParallelEnd(ompt_data_t*, ompt_data_t*, int, const void*) {
+    ThreadStats* stats = threadStats();
+    uint64_t now = nowNs();
+    if (stats->task_end != 0 && now > stats->task_end) stats->join_ns += now - stats->task_end;
+}
+
+static void onImplicitTask(ompt_scope_endpoint_t endpoint, ompt_data_t* parallel_data, ompt_data_t*,
+                           unsigned int, unsigned int, int flags) {
+    if (flags & ompt_task_initial) return;
+    ThreadStats* stats = threadStats();
+    uint64_t now = nowNs();
+
+    if (endpoint == ompt_scope_begin) {
+        stats->implicit_tasks++;
+        stats->task_begin = now;
+        if (parallel_data != nullptr && parallel_data->value != 0 && now > parallel_data->value) {
+            stats->fork_ns += now - parallel_data->value;
+        }
+    } else if (endpoint == ompt_scope_end) {
+        if (stats->task_begin != 0) stats->task_ns += now - stats->task_begin;
+        stats->task_end = now;
+    }
+}
+
+static void onSyncRegionWait(ompt_sync_region_t, ompt_scope_endpoint_t endpoint, ompt_data_t*,
+                             ompt_data_t*, const void*) {
+    ThreadStats* stats = threadStats();
+    if (endpoint == ompt_scope_begin) {
+        stats->wait_begin = nowNs();
+    } else if (endpoint == ompt_scope_end && stats->wait_begin != 0) {
+        stats->barrier_ns += nowNs() - stats->wait_begin;
+        stats->barriers++;
+        stats->wait_begin = 0;
+    }
+}
+
+static void onMutexAcquire(ompt_mutex_t, unsigned int, unsigned int, ompt_wait_id_t, const void*) {
+    threadStats()->lock_begin = nowNs();
+}
+
+static void onMutexAcquired(ompt_mutex_t, ompt_wait_id_t, const void*) {
+    ThreadStats* stats = threadStats();
+    if (stats->lock_begin != 0) {
+        stats->lock_ns += nowNs() - stats->lock_begin;
+        stats->locks++;
+        stats->lock_begin = 0;
+    }
+}
+
+static void onWork(ompt_work_t wstype, ompt_scope_endpoint_t endpoint, ompt_data_t*, ompt_data_t*,
+                   uint64_t, const void*) {
+    if (wstype != ompt_work_loop) return;
+    ThreadStats* stats = threadStats();
+    if (endpoint == ompt_scope_begin) {
+        stats->loops++;
+        stats->loop_begin = nowNs();
+    } else if (endpoint == ompt_scope_end && stats->loop_begin != 0) {
+        stats->loop_ns += nowNs() - stats->loop_begin;
+        stats->loop_begin = 0;
+    }
+}
+
+static void onDispatch(ompt_data_t*, ompt_data_t*, ompt_dispatch_t, ompt_data_t) {
+    threadStats()->chunks++;
+}
+
+static void onTaskCreate(ompt_data_t*, const ompt_frame_t*, ompt_data_t*, int flags, int, const void*) {
+    if (flags & ompt_task_explicit) threadStats()->tasks_created++;
+}
+
+// Function to print milliseconds with a fixed width
+static void printMs(FILE* out, uint64_t ns) {
+    fprintf(out, " %11.3f", ns / 1e6);
+}
+
+// Function to print the per-thread table and the totals
+static void printReport(FILE* out) {
+    std::lock_guard<std::mutex> guard(registry_lock);
+    uint64_t wall = nowNs() - start_ns;
+
+    fprintf(out, "\nOpenMP runtime profile (OMPT), times in ms, wall %.3f ms\n", wall / 1e6);
+    fprintf(out, "%6s %8s %11s %11s %11s %11s %11s %11s %11s %9s %9s %9s %9s\n", "thread", "tasks", "task",
+            "useful", "fork", "join", "barrier", "lock", "loop", "barriers", "locks", "loops",
+            dispatch_supported ? "chunks" : "chunks*");
+
+    ThreadStats total;
+    for (const ThreadStats* s : registry) {
+        if (s->implicit_tasks == 0 && s->regions == 0) continue;
+        uint64_t waits = s->barrier_ns + s->lock_ns;
+        uint64_t useful = s->task_ns > waits ? s->task_ns - waits : 0;
+        fprintf(out, "%6d %8llu", s->index, static_cast<unsigned long long>(s->implicit_tasks));
+        printMs(out, s->task_ns);
+        printMs(out, useful);
+        printMs(out, s->fork_ns);
+        printMs(out, s->join_ns);
+        printMs(out, s->barrier_ns);
+        printMs(out, s->lock_ns);
+        printMs(out, s->loop_ns);
+        fprintf(out, " %9llu %9llu %9llu %9llu\n", static_cast<unsigned long long>(s->barriers),
+                static_cast<unsigned long long>(s->locks), static_cast<unsigned long long>(s->loops),
+                static_cast<unsigned long long>(s->chunks));
+
+        total.implicit_tasks += s->implicit_tasks;
+        total.task_ns += s->task_ns;
+        total.fork_ns += s->fork_ns;
+        total.join_ns += s->join_ns;
+        total.barrier_ns += s->barrier_ns;
+        total.lock_ns += s->lock_ns;
+        total.regions += s->regions;
+        total.tasks_created += s->tasks_created;
+    }
+
+    uint64_t overhead = total.fork_ns + total.join_ns + total.barrier_ns + total.lock_ns;
+    uint64_t useful = total.task_ns > total.barrier_ns + total.lock_ns
+                          ? total.task_ns - total.barrier_ns - total.lock_ns : 0;
+    fprintf(out, "Parallel regions: %llu, explicit tasks created: %llu\n",
+            static_cast<unsigned long long>(total.regions), static_cast<unsigned long long>(total.tasks_created));
+    fprintf(out, "Useful work: %.3f ms, runtime overhead (fork + join + barrier + lock): %.3f ms (%.1f%%)\n",
+            useful / 1e6, overhead / 1e6, useful + overhead > 0 ? 100.0 * overhead / (useful + overhead) : 0.0);
+    if (!dispatch_supported) {
+        fprintf(out, "* chunk dispatch events are not supported by this runtime\n");
+    }
+}
+
+static int initializeTool(ompt_function_lookup_t lookup, int, ompt_data_t*) {
+    ompt_set_callback_t set_callback = (ompt_set_callback_t)lookup("ompt_set_callback");
+    get_thread_data = (ompt_get_thread_data_t)lookup("ompt_get_thread_data");
+    if (set_callback == nullptr || get_thread_data == nullptr) return 0;
+
+    start_ns = nowNs();
+    set_callback(ompt_callback_thread_begin, (ompt_callback_t)onThreadBegin);
+    set_callback(ompt_callback_parallel_begin, (ompt_callback_t)onParallelBegin);
+    set_callback(ompt_callback_parallel_end, (ompt_callback_t)onParallelEnd);
+    set_callback(ompt_callback_implicit_task, (ompt_callback_t)onImplicitTask);
+    set_callback(ompt_callback_sync_region_wait, (ompt_callback_t)onSyncRegionWait);
+    set_callback(ompt_callback_mutex_acquire, (ompt_callback_t)onMutexAcquire);
+    set_callback(ompt_callback_mutex_acquired, (ompt_callback_t)onMutexAcquired);
+    set_callback(ompt_callback_work, (ompt_callback_t)onWork);
+    set_callback(ompt_callback_task_create, (ompt_callback_t)onTaskCreate);
+    ompt_set_result_t dispatch = set_callback(ompt_callback_dispatch, (ompt_callback_t)onDispatch);
+    dispatch_supported = dispatch != ompt_set_never && dispatch != ompt_set_error;
+    return 1;   // Non-zero keeps the tool active
+}
+
+static void finalizeTool(ompt_data_t*) {
+    const char* path = getenv("OMPT_PROFILER_OUTPUT");
+    FILE* out = stderr;
+    if (path != nullptr && path[0] != '\0') {
+        out = fopen(path, "w");
+        if (out == nullptr) {
+            fprintf(stderr, "Error: Unable to open %s\n", path);
+            out = stderr;
+        }
+    }
+    printReport(out);
+    if (out != stderr) fclose(out);
+}
+
+extern "C" ompt_start_tool_result_t* ompt_start_tool(unsigned int, const char*) {
+    static ompt_start_tool_result_t result = {&initializeTool, &finalizeTool, {0}};
+    return &result;
+}